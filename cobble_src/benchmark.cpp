@@ -0,0 +1,201 @@
+#include "card_table.h"
+#include "cyclic_plane.h"
+#include "deck_generator.h"
+#include "deck_validator.h"
+#include "parallel.h"
+#include "projective_plane.h"
+#include "random.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Largest order for which the O(N^2) reference construction is still measured
+ */
+constexpr int MAX_SCAN_ORDER = 101;
+/**
+ * Largest order for which decks of all generators are validated
+ */
+constexpr int MAX_VALIDATED_ORDER = 64;
+/**
+ * Number of cards matched against the centre card of the card table
+ */
+constexpr int TABLE_CARD_COUNT = 8;
+/**
+ * Number of measured changes of the centre card of the card table
+ */
+constexpr int TABLE_ROUNDS = 10000;
+
+/**
+ * Measure run time of a function
+ * @param function Measured function
+ * @return Run time in milliseconds
+ */
+double measure(const function<void()>& function) {
+    auto start = chrono::steady_clock::now();
+    function();
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(end - start).count();
+}
+
+//---------------------------------------------------------------------
+//  BENCHMARK
+//  compares all deck generators (one thread each), checks that their decks are valid
+//---------------------------------------------------------------------
+int main() {
+    vector<int> orders {2, 3, 4, 5, 7, 8, 9, 11, 13, 16, 17, 19, 23, 25, 27, 29, 31, 32, 49, 64, 81, 101, 127, 128, 256, 257};
+    const auto& generators = DeckGenerator::GetAll();
+    cout << setw(8) << "order" << setw(10) << "lines";
+    for (const DeckGenerator* generator : generators) {
+        cout << setw(14) << string(generator->GetName()) + " [ms]";
+    }
+    cout << setw(8) << "valid" << endl;
+    for (int order : orders) {
+        cout << setw(8) << order << setw(10) << ProjectivePlane::GetSizeFromOrder(order);
+        bool valid = true;
+        for (const DeckGenerator* generator : generators) {
+            if (string(generator->GetName()) == "scan" && order > MAX_SCAN_ORDER) {
+                cout << setw(14) << "-";
+                continue;
+            }
+            IncidenceTable table{};
+            double time = measure([&]() { table = generator->Generate(order, 1); });
+            if (order <= MAX_VALIDATED_ORDER) {
+                valid = valid && DeckValidator::IsValid(table, Parallel::GetThreadCount());
+            }
+            cout << setw(14) << fixed << setprecision(3) << time;
+        }
+        cout << setw(8) << (order > MAX_VALIDATED_ORDER ? "-" : valid ? "yes" : "NO") << endl;
+    }
+
+    // cyclic planes store only the difference set, so they scale to millions of cards
+    constexpr int LOOKUP_COUNT = 1000000;
+    vector<int> cyclicOrders {31, 257, 1021, 1024, 2003};
+    cout << endl << setw(8) << "order" << setw(10) << "cards" << setw(14) << "find [ms]" << setw(14) << "lookup [ns]" << endl;
+    for (int order : cyclicOrders) {
+        unique_ptr<CyclicPlane> plane;
+        double findTime = measure([&]() { plane = make_unique<CyclicPlane>(order); });
+        int cardCount = plane->GetLineCount();
+        double lookupTime = measure([&]() {
+            for (int i = 0; i < LOOKUP_COUNT; ++i) {
+                int line1 = (int)((i * 7919L) % cardCount);
+                int line2 = (int)((line1 + 1 + (i * 104729L) % (cardCount - 1)) % cardCount);
+                plane->GetCommonPoint(line1, line2);
+            }
+        });
+        cout << setw(8) << order << setw(10) << cardCount << setw(14) << fixed << setprecision(3) << findTime
+             << setw(14) << lookupTime * 1e6 / LOOKUP_COUNT << endl;
+    }
+
+    // parallel generation, full table for order 257, streamed chunks for order 509
+    constexpr int CHUNK_LINES = 4096;
+    cout << endl << setw(8) << "threads" << setw(20) << "257 full [ms]" << setw(20) << "509 chunks [ms]" << endl;
+    ProjectivePlane plane257{257};
+    ProjectivePlane plane509{509};
+    for (int threadCount = 1; threadCount <= Parallel::GetThreadCount(); threadCount *= 2) {
+        double fullTime = measure([&]() { plane257.Generate(threadCount); });
+        double chunkTime = measure([&]() {
+            plane509.GenerateChunks(CHUNK_LINES, threadCount, [](int /*firstLine*/, int /*lineCount*/, const int* /*points*/) {});
+        });
+        cout << setw(8) << threadCount << setw(20) << fixed << setprecision(3) << fullTime << setw(20) << chunkTime << endl;
+    }
+
+    // validation of the "exactly one common symbol" invariant over all pairs of cards
+    vector<int> validatedOrders {31, 47, 64};
+    int threadCount = Parallel::GetThreadCount();
+    cout << endl << setw(8) << "order" << setw(14) << "pairs" << setw(14) << "1 thread [ms]"
+         << setw(14) << to_string(threadCount) + " thr. [ms]" << setw(8) << "valid" << endl;
+    for (int order : validatedOrders) {
+        IncidenceTable table = ProjectivePlane{order}.Generate(threadCount);
+        long long pairCount = (long long)table.GetLineCount() * (table.GetLineCount() - 1) / 2;
+        bool valid = true;
+        double singleTime = measure([&]() { valid = DeckValidator::IsValid(table); });
+        double parallelTime = measure([&]() { valid = valid && DeckValidator::IsValid(table, threadCount); });
+        cout << setw(8) << order << setw(14) << pairCount << setw(14) << fixed << setprecision(3) << singleTime
+             << setw(14) << parallelTime << setw(8) << (valid ? "yes" : "NO") << endl;
+    }
+
+    // card table, new centre card matched against all cards on the table in every round (e.g. every frame),
+    // 251 is the largest order, whose symbols fit into SymbolId
+    vector<int> tableOrders {31, 127, 251};
+    cout << endl << setw(8) << "order" << setw(8) << "cards" << setw(16) << "centre [us]"
+         << setw(16) << "batch [us]" << setw(8) << "valid" << endl;
+    for (int order : tableOrders) {
+        IncidenceTable table = ProjectivePlane{order}.Generate(threadCount);
+        int lineCount = table.GetLineCount();
+        int lineSize = order + 1;
+        vector<SymbolId> symbols{};
+        symbols.reserve((size_t)lineCount * lineSize);
+        for (int line = 0; line < lineCount; ++line) {
+            for (int point : table.GetLine(line)) {
+                symbols.push_back(static_cast<SymbolId>(point));
+            }
+        }
+        vector<Card> cards{};
+        for (int line = 0; line < lineCount; ++line) {
+            cards.emplace_back(line, Point{0, 0, 0}, symbols.data() + (size_t)line * lineSize, lineSize);
+        }
+        // rounds are chosen in advance, so that only the card table is measured
+        Random random{static_cast<uint64_t>(order)};
+        vector<int> centres(TABLE_ROUNDS);
+        for (int& centre : centres) {
+            centre = random.NextInt(lineCount);
+        }
+        vector<const Card*> tableCards{};
+        CardTable cardTable{table.GetPointCount()};
+        cardTable.Resize(TABLE_CARD_COUNT);
+        for (int idx = 0; idx < TABLE_CARD_COUNT; ++idx) {
+            tableCards.push_back(&cards[(idx * lineCount) / TABLE_CARD_COUNT]);
+            cardTable.SetCard(idx, tableCards.back());
+        }
+        // common symbol of 2 different lines lies on both of them, a line has no common symbol with itself
+        auto isCommon = [&](int line1, int line2, SymbolId symbol) {
+            if (line1 == line2) {
+                return symbol == CardTable::NO_SYMBOL;
+            }
+            IndexSpan lines = table.GetLinesThrough(symbol);
+            return find(lines.begin(), lines.end(), line1) != lines.end()
+                   && find(lines.begin(), lines.end(), line2) != lines.end();
+        };
+        bool valid = true;
+        double centreTime = measure([&]() {
+            for (int centre : centres) {
+                cardTable.SetCenter(&cards[centre]);
+            }
+        });
+        for (int round = 0; round < TABLE_ROUNDS; round += TABLE_ROUNDS / 100) {
+            cardTable.SetCenter(&cards[centres[round]]);
+            for (int idx = 0; idx < TABLE_CARD_COUNT; ++idx) {
+                valid = valid && isCommon(centres[round], tableCards[idx]->Id_, cardTable.GetCommonSymbol(idx));
+            }
+        }
+        vector<SymbolId> common(TABLE_CARD_COUNT);
+        double batchTime = measure([&]() {
+            for (int centre : centres) {
+                cardTable.FindCommonSymbols(&cards[centre], tableCards.data(), TABLE_CARD_COUNT, common.data());
+            }
+        });
+        for (int idx = 0; idx < TABLE_CARD_COUNT; ++idx) {
+            valid = valid && isCommon(centres.back(), tableCards[idx]->Id_, common[idx]);
+        }
+        // the centre card can also lie on the table
+        cardTable.SetCenter(tableCards[0]);
+        cardTable.FindCommonSymbols(tableCards[0], tableCards.data(), TABLE_CARD_COUNT, common.data());
+        for (int idx = 0; idx < TABLE_CARD_COUNT; ++idx) {
+            valid = valid && isCommon(tableCards[0]->Id_, tableCards[idx]->Id_, cardTable.GetCommonSymbol(idx))
+                    && isCommon(tableCards[0]->Id_, tableCards[idx]->Id_, common[idx]);
+        }
+        cout << setw(8) << order << setw(8) << TABLE_CARD_COUNT << setw(16) << fixed << setprecision(3)
+             << centreTime * 1000 / TABLE_ROUNDS << setw(16) << batchTime * 1000 / TABLE_ROUNDS
+             << setw(8) << (valid ? "yes" : "NO") << endl;
+    }
+    return 0;
+}
@@ -2,8 +2,12 @@
 #include "card.h"
 #include "graphic_utils.h"
 
-#include "SDL2_rotozoom.h"
 #include "SDL_ttf.h"
+#include "SDL2_gfxPrimitives.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 
 using namespace std;
 
@@ -13,77 +17,128 @@ double toRadians(int degrees) {
     return PI * degrees / 180;
 }
 
-void Card::AddImage(const Image& image) {
-    Images_.push_back(image);
-}
 
-std::string Card::GetCommon(const Card* card) {
-    for (auto&& image1 : Images_) {
-        for (auto&& image2 : card->Images_) {
-            if (image1.Name_ == image2.Name_) {
-                return image1.Name_;
-            }
-        }
+void RenderedCard::Init(Random& random) {
+    // images are placed in a spiral, starting from the center outward
+    int imageCount = card_->GetSymbolCount();
+    int imageSize = radius_ / imageCount; // image size is counted so that images can fit side by side in the radius of the card
+    int radiusIncrement = imageSize / 2; // how much is image moved outward from the previous one
+    int degrees = random.NextInt(360); // start on random degree, so every card looks different
+    int radiusPart = 0;
+    placedImages_.clear();
+    for (int i = 0; i < imageCount; ++i) {
+        const Image& image = (*images_)[card_->GetSymbol(i)];
+        double scale = imageSize / (double)image.Width_; // scale factor
+        int rotation = random.NextInt(360); // random angle to rotate image (counterclockwise)
+        int width = imageSize;
+        int height = lround(image.Height_ * scale);
+        degrees += DEGREE_INCREMENT;
+        radiusPart += radiusIncrement;
+        int x = radius_ + cos(toRadians(degrees)) * radiusPart; // coordinates of top left corner of rotated image
+        int y = radius_ + sin(toRadians(degrees)) * radiusPart;
+        // bounding box of the rotated image, its center is the center of the image
+        double boxWidth = fabs(width * cos(toRadians(rotation))) + fabs(height * sin(toRadians(rotation)));
+        double boxHeight = fabs(width * sin(toRadians(rotation))) + fabs(height * cos(toRadians(rotation)));
+        int imageX = lround(x + (boxWidth - width) / 2);
+        int imageY = lround(y + (boxHeight - height) / 2);
+        placedImages_.push_back(PlacedImage{SDL_Rect{imageX, imageY, width, height}, -(double)rotation});
     }
-    return "";
+    rendered_ = false;
 }
 
+void RenderedCard::SetCenter(int centerX, int centerY) {
+    centerX_ = centerX;
+    centerY_ = centerY;
+}
 
-
-void RenderedCard::Init() {
-    startDegree_ = rand() % 360; // start on random degree, so every card looks different
-    for (int i = 0; i < card_->Images_.size(); ++i) {
-        int imageRotation = rand() % 360; // random angle to rotate image;
-        imageRotations_.push_back(imageRotation);
+void RenderedCard::addToBatch(const Image& image, const PlacedImage& placed) {
+    // all images from the same atlas texture are drawn at once
+    auto batch = find_if(batches_.begin(), batches_.end(), [&](const Batch& batch) {
+        return batch.Texture_ == image.Texture_;
+    });
+    if (batch == batches_.end()) {
+        batches_.push_back(Batch{image.Texture_});
+        batch = batches_.end() - 1;
+    }
+    int textureWidth = 1;
+    int textureHeight = 1;
+    SDL_QueryTexture(image.Texture_, nullptr, nullptr, &textureWidth, &textureHeight);
+    const SDL_Rect& rect = placed.Rect_;
+    const SDL_Rect& source = image.TextureRect_;
+    double radians = placed.Angle_ * PI / 180;
+    float centerX = rect.x + rect.w / 2.0f;
+    float centerY = rect.y + rect.h / 2.0f;
+    // corners of the image rotated clockwise around its center: top left, top right, bottom right, bottom left
+    const int cornersX[] = {0, 1, 1, 0};
+    const int cornersY[] = {0, 0, 1, 1};
+    int first = static_cast<int>(batch->Vertices_.size());
+    for (int corner = 0; corner < 4; ++corner) {
+        float u = (cornersX[corner] - 0.5f) * rect.w;
+        float v = (cornersY[corner] - 0.5f) * rect.h;
+        SDL_Vertex vertex{};
+        vertex.position.x = centerX + u * cos(radians) - v * sin(radians);
+        vertex.position.y = centerY + u * sin(radians) + v * cos(radians);
+        vertex.color = SDL_Color{255, 255, 255, 255};
+        vertex.tex_coord.x = (source.x + cornersX[corner] * source.w) / (float)textureWidth;
+        vertex.tex_coord.y = (source.y + cornersY[corner] * source.h) / (float)textureHeight;
+        batch->Vertices_.push_back(vertex);
+    }
+    for (int corner : {0, 1, 2, 0, 2, 3}) {
+        batch->Indices_.push_back(first + corner);
     }
 }
 
-void RenderedCard::Draw(SDL_Renderer *renderer) {
-    // images are placed in a spiral, starting from the center outward
-    int imageCount = card_->Images_.size();
-    int imageSize = radius_ / imageCount; // image size is counted so that images can fit side by side in the radius of the card
-    int radiusIncrement = imageSize / 2; // how much is image moved outward from the previous one
-    int degrees = startDegree_;
-    int radiusPart = 0;
-    for (int i = 0; i < card_->Images_.size(); ++i) {
-        Image image = card_->Images_[i];
-        double scale = imageSize / (double)image.Surface_->w; // scale factor
-        int rotation = imageRotations_[i];
-        auto scaledSurface = rotozoomSurface(image.Surface_, rotation, scale, SMOOTHING_OFF);
-        auto texture = SDL_CreateTextureFromSurface(renderer, scaledSurface);
-        degrees += DEGREE_INCREMENT;
-        radiusPart += radiusIncrement;
-        int x = centerX_ + cos(toRadians(degrees)) * radiusPart; // coordinates of top left corner of image
-        int y = centerY_ + sin(toRadians(degrees)) * radiusPart;
-        SDL_Rect destinationRect {x, y, scaledSurface->w, scaledSurface->h};
-        SDL_RenderCopy(renderer, texture, NULL, &destinationRect);
-        // save rendered image border
-        int scaledWidth, scaledHeight = 0;
-        rotozoomSurfaceSize(image.Surface_->w, image.Surface_->h, rotation, scale, &scaledWidth, &scaledHeight);
-        addImageBorder(i, x, y, scaledWidth, scaledHeight);
+void RenderedCard::Draw(SDL_Renderer *renderer, CardTextureCache& cache) {
+    SDL_Rect bounds = getBounds();
+    SDL_Texture* texture = rendered_ ? cache.Find(card_->Id_) : nullptr;
+    if (texture == nullptr) {
+        texture = cache.Acquire(renderer, card_->Id_, bounds.w, bounds.h);
+        if (texture == nullptr) {
+            // renderer without render targets, the card is rendered every frame
+            SDL_RenderSetViewport(renderer, &bounds);
+            render(renderer);
+            SDL_RenderSetViewport(renderer, nullptr);
+            return;
+        }
+        SDL_SetRenderTarget(renderer, texture);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+        SDL_RenderClear(renderer);
+        render(renderer);
+        SDL_SetRenderTarget(renderer, nullptr);
+        rendered_ = true;
     }
+    SDL_RenderCopy(renderer, texture, nullptr, &bounds);
 }
 
-void RenderedCard::addImageBorder(int imageIdx, int imagePosX, int imagePosY, int width, int height) {
-    renderedImageBorders_.insert(pair<int, SDL_Rect>(imageIdx, SDL_Rect{imagePosX, imagePosY, width, height}));
+void RenderedCard::render(SDL_Renderer* renderer) {
+    // batches refer to atlas textures, which are recreated when the renderer loses them, so they are built here
+    batches_.clear();
+    for (int i = 0; i < static_cast<int>(placedImages_.size()); ++i) {
+        addToBatch((*images_)[card_->GetSymbol(i)], placedImages_[i]);
+    }
+    filledCircleRGBA(renderer, radius_, radius_, radius_,
+                     BACKGROUND_COLOR.r, BACKGROUND_COLOR.g, BACKGROUND_COLOR.b, BACKGROUND_COLOR.a);
+    circleRGBA(renderer, radius_, radius_, radius_, BORDER_COLOR.r, BORDER_COLOR.g, BORDER_COLOR.b, BORDER_COLOR.a);
+    for (const Batch& batch : batches_) {
+        SDL_RenderGeometry(renderer, batch.Texture_, batch.Vertices_.data(), static_cast<int>(batch.Vertices_.size()),
+                           batch.Indices_.data(), static_cast<int>(batch.Indices_.size()));
+    }
 }
 
 // returns NULL if no image was clicked
-Image* RenderedCard::GetClickedImage(int mouseX, int mouseY) {
-    for (auto&& borderPair : renderedImageBorders_) {
-        int imageIdx = borderPair.first;
-        SDL_Rect rect = borderPair.second;
-        if (GraphicUtils::IsInRect(rect, mouseX, mouseY)) {
-            return &card_->Images_[imageIdx];
+const Image* RenderedCard::GetClickedImage(int mouseX, int mouseY) const {
+    SDL_Rect bounds = getBounds();
+    mouseX -= bounds.x;
+    mouseY -= bounds.y;
+    for (int i = 0; i < static_cast<int>(placedImages_.size()); ++i) {
+        const PlacedImage& placed = placedImages_[i];
+        if (GraphicUtils::IsInRotatedRect(placed.Rect_, placed.Angle_, mouseX, mouseY)) {
+            return &(*images_)[card_->GetSymbol(i)];
         }
     }
     return nullptr;
 }
 
-std::string RenderedCard::GetCommon(const RenderedCard &card) {
-    return card_->GetCommon(card.card_);
-}
-
 Card* RenderedCard::GetCard() {
     return card_;
 }
@@ -2,34 +2,17 @@
 #ifndef COBBLE_SRC_CARD_H
 #define COBBLE_SRC_CARD_H
 
+#include "card_texture_cache.h"
+#include "deck_cache.h"
 #include "image_loader.h"
+#include "pair_tracker.h"
+#include "playing_card.h"
+#include "projective_plane.h"
+#include "random.h"
+#include <chrono>
 #include <vector>
 #include <map>
-
-/**
- * Playing card containing images of symbols
- */
-class Card {
-public:
-    /**
-     * List of images on the card
-     */
-    std::vector<Image> Images_{};
-    /**
-     * Add new image to the list of images.
-     * @param image Image to add
-     */
-    void AddImage(const Image& image);
-    /**
-     * Get the name of the common image between 2 cards.
-     * @param card Card to compare
-     * @return Name of the common image
-     */
-    std::string GetCommon(const Card* card);
-private:
-
-
-};
+#include <memory>
 
 /**
  * Class representing a card rendered to the screen
@@ -40,34 +23,43 @@ public:
     /**
      * Rendered card has a circular form.
      * @param card Card to be rendered
+     * @param images List of all images, indexed by symbol IDs
      * @param centerX X coordinate of the center of the circle (card)
      * @param centerY Y coordinate of the center of the circle (card)
      * @param radius Circle (card) radius
      */
-    RenderedCard(Card* card, int centerX, int centerY, int radius)
-            : card_(card), centerX_(centerX), centerY_(centerY), radius_(radius) {}
+    RenderedCard(Card* card, const std::vector<Image>* images, int centerX, int centerY, int radius)
+            : card_(card), images_(images), centerX_(centerX), centerY_(centerY), radius_(radius) {}
+    /**
+     * Initialize card, choose random layout of images - position, size and rotation of every image.
+     * Layout is relative to the card, so it is kept when the card is moved (see SetCenter).
+     * @param random Generator of random numbers
+     */
+    void Init(Random& random);
     /**
-     * Initialize card
+     * Move card to another place on the screen, layout and rendered texture of the card are kept
+     * @param centerX X coordinate of the center of the circle (card)
+     * @param centerY Y coordinate of the center of the circle (card)
      */
-    void Init();
+    void SetCenter(int centerX, int centerY);
     /**
      * Render card to a renderer.
+     *
+     * Background, border and images of the card are rendered into a texture from the cache when the card is drawn
+     * for the first time after Init (or after the texture was dropped from the cache), then the texture is copied.
+     * Rotated images are then turned into triangles with coordinates in the current atlas textures,
+     * so the images are rendered with one SDL_RenderGeometry call per atlas texture (usually one).
      * @param renderer Renderer
+     * @param cache Cache of card textures
      */
-    void Draw(SDL_Renderer *renderer);
+    void Draw(SDL_Renderer *renderer, CardTextureCache& cache);
     /**
      * Get image on card that was clicked from mouse coordinates.
      * @param mouseX X coordinate of the mouse
      * @param mouseY Y coordinate of the mouse
      * @return Clicked image or null (if nothing is clicked)
      */
-    Image* GetClickedImage(int mouseX, int mouseY);
-    /**
-     * Get the name of the common image between 2 cards.
-     * @param card Card to compare
-     * @return Name of the common image
-     */
-    std::string GetCommon(const RenderedCard& card);
+    const Image* GetClickedImage(int mouseX, int mouseY) const;
     /**
      * Get inner card object
      * @return Inner card
@@ -78,14 +70,36 @@ private:
      * Degree increment for spacing images on cards
      */
     static const int DEGREE_INCREMENT = 110;
+    static constexpr SDL_Color BACKGROUND_COLOR{255, 255, 255, 255};
+    static constexpr SDL_Color BORDER_COLOR{0, 0, 0, 255};
     Card* card_;
+    const std::vector<Image>* images_;
     int centerX_;
     int centerY_;
     int radius_;
-    std::map<int, SDL_Rect> renderedImageBorders_{};
-    int startDegree_;
-    std::vector<int> imageRotations_{};
-    void addImageBorder(int imageIdx, int imagePosX, int imagePosY, int width, int height);
+    bool rendered_ = false; // whether the current layout was rendered into the cache
+    /**
+     * Image placed on the card
+     */
+    struct PlacedImage {
+        SDL_Rect Rect_; // position relative to the top left corner of the card and size before rotation
+        double Angle_; // clockwise rotation around the center of the rectangle in degrees
+    };
+    std::vector<PlacedImage> placedImages_{};
+    /**
+     * Images drawn from one atlas texture with one draw call
+     */
+    struct Batch {
+        SDL_Texture* Texture_;
+        std::vector<SDL_Vertex> Vertices_{};
+        std::vector<int> Indices_{};
+    };
+    std::vector<Batch> batches_{};
+    void addToBatch(const Image& image, const PlacedImage& placed);
+    void render(SDL_Renderer* renderer);
+    SDL_Rect getBounds() const {
+        return SDL_Rect{centerX_ - radius_, centerY_ - radius_, 2 * radius_ + 1, 2 * radius_ + 1};
+    }
 };
 
 /**
@@ -97,6 +111,20 @@ private:
  * This guarantees that every 2 cards have exactly 1 image in common.
  * Order of the plane (n) determines the size of the deck.
  * The deck will contain (n^2 + n + 1) cards with (n + 1) images on each card.
+ *
+ * Cards are created lazily - the deck shuffles indexes of lines and computes a card only when it is opened
+ * for the first time, opened cards are kept for next games with the same deck (see Reset).
+ * Cards hold only symbol IDs, so shuffling and opening cards never copies images.
+ * Symbols of opened cards are appended to one table of the deck with room for all cards reserved,
+ * so a card costs 2 bytes per symbol and a few bytes for its line.
+ * Lines are read from a table built at compile time (small orders) or from the deck cache,
+ * a plane missing in the cache is generated once and saved.
+ *
+ * Projective planes exist only for prime power orders. For other orders the largest deck,
+ * that can be found within a time limit, is searched for by DeckSearch and saved to the deck cache.
+ *
+ * In endless mode the deck never runs out - cards are opened in pairs, which were not shown together yet,
+ * and when all pairs were shown, the deck is reshuffled and starts over.
  */
 class Deck {
 public:
@@ -104,22 +132,60 @@ public:
     /**
      * Initialize deck.
      *
-     * Create a projective plane of corresponding size. Use the plane to assign images to cards.
+     * Create a projective plane of corresponding size (or find a deck by search, if there is no plane).
+     * Images are assigned to cards when they are opened.
+     *
+     * Deck can be smaller than the whole plane, then cards are chosen greedily one by one,
+     * every next card is the one whose symbols are closest to be used the average number of times,
+     * and chosen cards are then swapped for better ones while it improves the balance of symbols.
+     * Cards are chosen again in every game (see Reset), ties are broken randomly, so games use different cards.
      * @param images List of all images in the game
      * @param imagesPerCard Number of images per card
+     * @param cache Cache of generated planes
+     * @param cardCount Number of cards in the deck, 0 for all (n^2 + n + 1) cards
+     * @param random Generator of random numbers used to choose between equally good cards
      */
-    void Init(const std::vector<Image>& images, int imagesPerCard);
+    void Init(const std::vector<Image>& images, int imagesPerCard, DeckCache& cache, int cardCount, Random& random);
+    /**
+     * Get the common image of 2 different cards.
+     *
+     * Common image is the intersection of the lines of the cards, it is computed from their equations in O(1).
+     * Common image of cards of a searched deck is found by intersecting their sorted lists of symbols.
+     * @param card1 First card
+     * @param card2 Second card
+     * @return Symbol ID of the common image, which is also its index in the list of all images
+     */
+    SymbolId GetCommonImage(const Card* card1, const Card* card2) const;
     /**
      * Shuffle cards.
      *
-     * Uses the Fisher–Yates shuffle
+     * Uses the Fisher–Yates shuffle on indexes of cards
+     * @param random Generator of random numbers
+     */
+    void Shuffle(Random& random);
+    /**
+     * Prepare the deck for a new game - shuffle all cards back into the deck
+     *
+     * Partial decks choose their cards again (see Init).
+     * Cards opened in previous games are reused, so after every card was opened once, the reset allocates nothing.
+     * @param random Generator of random numbers
      */
-    void Shuffle();
+    void Reset(Random& random);
     /**
      * Open the top card from the deck
      * @return Card
      */
     Card* GetNextCard();
+    /**
+     * Open a card, which was not shown together with the kept card yet (endless mode)
+     *
+     * If the kept card was already shown with all other cards, it is replaced by a card, which was not.
+     * When all pairs of cards were shown, the deck is reshuffled and all pairs can be shown again.
+     * @param kept Card staying on the table, it must be opened from this deck, it may be replaced
+     * @param random Generator of random numbers
+     * @return Opened card
+     */
+    Card* GetPartnerCard(Card*& kept, Random& random);
     /**
      * Get count of remaining (unopened) cards in the deck.
      * @return Number of remaining cards
@@ -131,8 +197,50 @@ public:
      */
     int GetTotalCardsCount();
 private:
-    std::vector<Card> cards_{};
+    const std::vector<Image>* images_ = nullptr;
+    /**
+     * Generator of planes (see DeckGenerator), its lines are numbered like equations of ProjectivePlane,
+     * so common images of cards can be found from their equations. Its planes are cached under its name.
+     */
+    static constexpr const char* PLANE_GENERATOR = "equation";
+    /**
+     * Name of the deck search in the deck cache
+     */
+    static constexpr const char* SEARCH_CACHE_BACKEND = "search";
+    /**
+     * Time spent searching for a deck, if there is no projective plane of given order
+     */
+    static constexpr std::chrono::milliseconds SEARCH_TIME_BUDGET{2000};
+    std::unique_ptr<ProjectivePlane> plane_; // null for searched decks
+    IncidenceTable table_{}; // empty if lines are computed on demand
+    std::vector<int> cardOrder_{};
+    std::vector<Card> cards_{}; // cards by index of line, without symbols until opened, never resized after Init
+    std::vector<SymbolId> symbols_{}; // symbols of opened cards, capacity for all cards, so it never reallocates
+    int lineSize_ = 0;
     int topCardIdx_;
+    std::unique_ptr<PairTracker> shownPairs_; // pairs of positions in cardOrder_, created in endless mode
+    std::vector<int> linePositions_{}; // position of every line in cardOrder_
+    int selectedCardCount_ = 0; // number of cards chosen from the plane in every game, 0 for all cards
+    /**
+     * Scratch space of selectBalancedCards, kept between games
+     */
+    struct CardSelection {
+        std::vector<int> Candidates_{}; // lines in random order
+        std::vector<int> SymbolCounts_{}; // number of selected cards with each symbol
+        std::vector<bool> Selected_{};
+        std::vector<double> AddCosts_{};
+        std::vector<double> RemoveCosts_{};
+    };
+    CardSelection selection_{};
+    Card createCard(int line);
+    void initPlane(int order, DeckCache& cache, int threadCount);
+    bool matchesPlane(int threadCount) const;
+    bool isPlayableDeck(int order, int threadCount) const;
+    void initSearchedDeck(int order, DeckCache& cache, int threadCount);
+    void selectBalancedCards(Random& random);
+    void addSymbols(IndexSpan points);
+    Card* openCard(int position);
+    void updateLinePositions();
 
 };
 
@@ -0,0 +1,72 @@
+#include "card_table.h"
+
+using namespace std;
+
+CardTable::CardTable(int symbolCount) : marked_((symbolCount + 63) / 64, 0) {}
+
+void CardTable::SetCenter(const Card* card) {
+    mark(center_, false);
+    center_ = card;
+    mark(center_, true);
+    for (size_t idx = 0; idx < cards_.size(); ++idx) {
+        commonSymbols_[idx] = findCommonSymbol(cards_[idx]);
+    }
+}
+
+void CardTable::Resize(int count) {
+    cards_.resize(count, nullptr);
+    commonSymbols_.resize(count, NO_SYMBOL);
+}
+
+void CardTable::SetCard(int idx, const Card* card) {
+    cards_[idx] = card;
+    commonSymbols_[idx] = findCommonSymbol(card);
+}
+
+int CardTable::FindCard(SymbolId symbol) const {
+    for (size_t idx = 0; idx < cards_.size(); ++idx) {
+        if (cards_[idx] != nullptr && commonSymbols_[idx] == symbol) {
+            return static_cast<int>(idx);
+        }
+    }
+    return -1;
+}
+
+void CardTable::FindCommonSymbols(const Card* card, const Card* const* cards, int count, SymbolId* symbols) {
+    // mark the card instead of the centre card for a while
+    mark(center_, false);
+    mark(card, true);
+    for (int idx = 0; idx < count; ++idx) {
+        symbols[idx] = cards[idx] != card ? matchMarked(cards[idx]) : NO_SYMBOL;
+    }
+    mark(card, false);
+    mark(center_, true);
+}
+
+void CardTable::mark(const Card* card, bool marked) {
+    if (card == nullptr) {
+        return;
+    }
+    for (int idx = 0; idx < card->GetSymbolCount(); ++idx) {
+        SymbolId symbol = card->GetSymbol(idx);
+        uint64_t bit = uint64_t{1} << (symbol % 64);
+        marked_[symbol / 64] = marked ? marked_[symbol / 64] | bit : marked_[symbol / 64] & ~bit;
+    }
+}
+
+SymbolId CardTable::findCommonSymbol(const Card* card) const {
+    // all symbols of the centre card are marked, so matching it with itself would OR them together
+    return card != nullptr && center_ != nullptr && card != center_ ? matchMarked(card) : NO_SYMBOL;
+}
+
+SymbolId CardTable::matchMarked(const Card* card) const {
+    // all symbols of the centre card are marked and exactly one of them is on the card,
+    // so OR of symbols of the card masked by their marks gives the common one
+    unsigned common = 0;
+    for (int idx = 0; idx < card->GetSymbolCount(); ++idx) {
+        SymbolId symbol = card->GetSymbol(idx);
+        unsigned isMarked = static_cast<unsigned>(marked_[symbol / 64] >> (symbol % 64)) & 1u;
+        common |= symbol & (0u - isMarked);
+    }
+    return static_cast<SymbolId>(common);
+}
@@ -0,0 +1,95 @@
+#ifndef COBBLE_SRC_CARD_TABLE_H
+#define COBBLE_SRC_CARD_TABLE_H
+
+#include "playing_card.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Cards on the table for game modes, where one centre card is matched against many cards at once
+ * (e.g. every player has a hand card and all of them look for a match with the centre pile)
+ *
+ * Symbols of the centre card are marked in a bitset of all symbols once, when the centre card changes.
+ * Common symbol of any other card is then found in one pass over its symbols without branches:
+ * the only marked symbol is selected by masking. Common symbols of all cards are kept up to date,
+ * so changing the centre card costs one pass over all cards and changing a hand card costs one pass over that card.
+ */
+class CardTable {
+public:
+    /**
+     * Common symbol of a card with itself, with empty place or with missing centre card, it is not ID of any symbol
+     */
+    static constexpr SymbolId NO_SYMBOL = UINT16_MAX;
+    /**
+     * @param symbolCount Number of symbols in the deck
+     */
+    explicit CardTable(int symbolCount);
+    /**
+     * Set the centre card and find its common symbols with all cards
+     * @param card Centre card
+     */
+    void SetCenter(const Card* card);
+    /**
+     * Get the centre card
+     * @return Centre card, null if not set
+     */
+    const Card* GetCenter() const {
+        return center_;
+    }
+    /**
+     * Set number of cards matched against the centre card, new places are empty
+     * @param count Number of cards
+     */
+    void Resize(int count);
+    /**
+     * Put card to a place on the table and find its common symbol with the centre card
+     * @param idx Place of the card
+     * @param card Card, null for empty place
+     */
+    void SetCard(int idx, const Card* card);
+    /**
+     * Get card on a place on the table
+     * @param idx Place of the card
+     * @return Card, null for empty place
+     */
+    const Card* GetCard(int idx) const {
+        return cards_[idx];
+    }
+    int GetCardCount() const {
+        return static_cast<int>(cards_.size());
+    }
+    /**
+     * Get common symbol of the centre card and a card on the table
+     * @param idx Place of the card
+     * @return Common symbol, NO_SYMBOL for empty place, for the centre card itself or if the centre card is not set
+     */
+    SymbolId GetCommonSymbol(int idx) const {
+        return commonSymbols_[idx];
+    }
+    /**
+     * Find the first card matching the centre card with given symbol
+     * @param symbol Symbol, e.g. clicked by player
+     * @return Place of the card, -1 if no card has this common symbol with the centre card
+     */
+    int FindCard(SymbolId symbol) const;
+    /**
+     * Find common symbols of a card with many cards in one pass
+     * @param card Card compared with all other cards
+     * @param cards Other cards, must not be null
+     * @param count Number of other cards
+     * @param symbols Place for common symbols, one for each of the other cards, NO_SYMBOL for the card itself
+     */
+    void FindCommonSymbols(const Card* card, const Card* const* cards, int count, SymbolId* symbols);
+
+private:
+    std::vector<uint64_t> marked_; // bitset of symbols of the centre card
+    const Card* center_ = nullptr;
+    std::vector<const Card*> cards_{};
+    std::vector<SymbolId> commonSymbols_{};
+    void mark(const Card* card, bool marked);
+    SymbolId findCommonSymbol(const Card* card) const;
+    SymbolId matchMarked(const Card* card) const;
+};
+
+#endif //COBBLE_SRC_CARD_TABLE_H
@@ -0,0 +1,59 @@
+#include "card_texture_cache.h"
+
+using namespace std;
+
+SDL_Texture* CardTextureCache::Find(int cardId) {
+    auto found = index_.find(cardId);
+    if (found == index_.end()) {
+        return nullptr;
+    }
+    entries_.splice(entries_.begin(), entries_, found->second);
+    return found->second->Texture_.get();
+}
+
+SDL_Texture* CardTextureCache::Acquire(SDL_Renderer* renderer, int cardId, int width, int height) {
+    auto found = index_.find(cardId);
+    if (found != index_.end()) {
+        if (found->second->Width_ == width && found->second->Height_ == height) {
+            entries_.splice(entries_.begin(), entries_, found->second);
+            return found->second->Texture_.get();
+        }
+        erase(found->second);
+    }
+    // drop least recently used textures, keep one of the same size for the new card
+    TexturePtr texture{};
+    size_t size = getSize(width, height);
+    while (!entries_.empty() && usedMemory_ + size > memoryBudget_) {
+        auto last = prev(entries_.end());
+        if (texture == nullptr && last->Width_ == width && last->Height_ == height) {
+            texture = move(last->Texture_);
+        }
+        erase(last);
+    }
+    if (texture == nullptr) {
+        if (!SDL_RenderTargetSupported(renderer)) {
+            return nullptr;
+        }
+        texture.reset(SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height));
+        if (texture == nullptr) {
+            return nullptr;
+        }
+        SDL_SetTextureBlendMode(texture.get(), SDL_BLENDMODE_BLEND);
+    }
+    entries_.push_front(Entry{cardId, width, height, move(texture)});
+    index_[cardId] = entries_.begin();
+    usedMemory_ += size;
+    return entries_.front().Texture_.get();
+}
+
+void CardTextureCache::Clear() {
+    entries_.clear();
+    index_.clear();
+    usedMemory_ = 0;
+}
+
+void CardTextureCache::erase(list<Entry>::iterator entry) {
+    usedMemory_ -= getSize(entry->Width_, entry->Height_);
+    index_.erase(entry->CardId_);
+    entries_.erase(entry);
+}
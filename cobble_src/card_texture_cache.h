@@ -0,0 +1,70 @@
+#ifndef COBBLE_SRC_CARD_TEXTURE_CACHE_H
+#define COBBLE_SRC_CARD_TEXTURE_CACHE_H
+
+#include "graphic_utils.h"
+
+#include "SDL.h"
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+
+/**
+ * Composite textures of rendered cards, keyed by card ID
+ *
+ * Every card is rendered once into its own target texture (see RenderedCard::Draw), the texture is kept
+ * while the card moves between piles, so a card costs one texture copy per frame.
+ * Textures of the least recently drawn cards are dropped when the memory budget is exceeded,
+ * a dropped texture of the same size is reused for the next card instead of creating a new one.
+ * Renderers can lose contents of render targets (e.g. Direct3D on resize or device loss), then the cache
+ * must be cleared and cards are rendered again.
+ */
+class CardTextureCache {
+public:
+    /**
+     * Default memory budget in bytes, a card of the default window (451 x 451 pixels) takes about 800 kB,
+     * so about 40 cards fit into the budget
+     */
+    static const size_t DEFAULT_MEMORY_BUDGET = 32 << 20;
+    explicit CardTextureCache(size_t memoryBudget = DEFAULT_MEMORY_BUDGET) : memoryBudget_(memoryBudget) {}
+    /**
+     * Find texture of a card and mark it as recently used
+     * @param cardId ID of the card
+     * @return Texture of the card, null if the card is not cached
+     */
+    SDL_Texture* Find(int cardId);
+    /**
+     * Get texture for (new) content of a card, previous content of the card is replaced
+     * @param renderer Renderer
+     * @param cardId ID of the card
+     * @param width Width of the texture
+     * @param height Height of the texture
+     * @return Render target texture with undefined content, null if the renderer does not support render targets
+     */
+    SDL_Texture* Acquire(SDL_Renderer* renderer, int cardId, int width, int height);
+    /**
+     * Drop all textures
+     */
+    void Clear();
+    size_t GetUsedMemory() const {
+        return usedMemory_;
+    }
+
+private:
+    struct Entry {
+        int CardId_;
+        int Width_;
+        int Height_;
+        TexturePtr Texture_;
+    };
+    size_t memoryBudget_;
+    size_t usedMemory_ = 0;
+    std::list<Entry> entries_{}; // most recently used first
+    std::unordered_map<int, std::list<Entry>::iterator> index_{};
+    void erase(std::list<Entry>::iterator entry);
+    static size_t getSize(int width, int height) {
+        return static_cast<size_t>(width) * height * 4;
+    }
+};
+
+#endif //COBBLE_SRC_CARD_TEXTURE_CACHE_H
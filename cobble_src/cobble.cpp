@@ -2,46 +2,265 @@
 // Created by Evgenia Golubeva on 18.04.2022.
 //
 
-#include "SDL2_rotozoom.h"
 #include "SDL_ttf.h"
 #include "SDL2_gfxPrimitives.h"
 
 #include "cobble.h"
+#include "deck_generator.h"
+#include "deck_search.h"
+#include "deck_validator.h"
+#include "parallel.h"
 #include "projective_plane.h"
+#include "static_plane.h"
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <math.h>
-#include <random>
 #include <cstdlib>
+#include <numeric>
 
 using namespace std;
 
 
-void Deck::Init(const std::vector<Image>& images, int imagesPerCard) {
-    ProjectivePlane plane{imagesPerCard - 1};
-    auto lines = plane.Generate();
-    auto linesIdx = plane.ConvertPointsToIdx(lines);
+void Deck::Init(const std::vector<Image>& images, int imagesPerCard, DeckCache& cache, int cardCount, Random& random) {
+    images_ = &images;
+    int order = imagesPerCard - 1;
+    int threadCount = Parallel::GetThreadCount();
+    if (GaloisField::IsPrimePower(order)) {
+        initPlane(order, cache, threadCount);
+    } else {
+        initSearchedDeck(order, cache, threadCount);
+    }
+    int lineCount = table_.GetLineCount() > 0 ? table_.GetLineCount() : plane_->GetPointCount();
+    lineSize_ = table_.GetLineCount() > 0 ? table_.GetLine(0).size() : plane_->GetLineSize();
+    cards_.assign(lineCount, Card{});
+    symbols_.clear();
+    symbols_.reserve((size_t)lineCount * lineSize_);
+    selectedCardCount_ = cardCount > 0 && cardCount < lineCount ? cardCount : 0;
+    if (selectedCardCount_ > 0) {
+        // cards are selected again in every game, so the table is kept even if it could not be cached
+        if (table_.GetLineCount() == 0) {
+            table_ = DeckGenerator::Find(PLANE_GENERATOR).Generate(order, threadCount);
+        }
+        selectBalancedCards(random);
+        return;
+    }
+    cardOrder_.resize(lineCount);
+    iota(cardOrder_.begin(), cardOrder_.end(), 0);
+}
+
+void Deck::initPlane(int order, DeckCache& cache, int threadCount) {
+    plane_ = make_unique<ProjectivePlane>(order);
+    const DeckGenerator& generator = DeckGenerator::Find(PLANE_GENERATOR);
+    // small planes are built at compile time, larger ones are generated once and then mapped from cache
+    bool found = StaticPlanes::Find(order, table_);
+    if (!found) {
+        // the checksum catches damaged files, a replaced or imported file must still number lines like the plane
+        found = cache.Find(generator.GetName(), order, table_) && matchesPlane(threadCount);
+    }
+    if (!found && !cache.Store(generator.GetName(), order, generator.Generate(order, threadCount), table_)) {
+        table_ = IncidenceTable{};
+    }
+}
+
+bool Deck::matchesPlane(int threadCount) const {
+    // common images are computed from equations, so line i of the table must be the line of equation i,
+    // one pass over the lines costs O(N * (n + 1)) instead of O(N^2 * (n + 1)) of DeckValidator
+    int lineCount = plane_->GetPointCount();
+    int lineSize = plane_->GetLineSize();
+    if (table_.GetLineCount() != lineCount || table_.GetPointCount() != lineCount
+        || table_.GetIncidenceCount() != IncidenceTable::GetIncidenceCount(lineCount, lineSize)) {
+        return false;
+    }
+    atomic<bool> matches{true};
+    Parallel::For(0, lineCount, threadCount, [&](int lineBegin, int lineEnd) {
+        vector<int> points(lineSize);
+        for (int line = lineBegin; line < lineEnd && matches; ++line) {
+            plane_->GetLine(line, points.data());
+            IndexSpan cached = table_.GetLine(line);
+            if (cached.size() != lineSize || !equal(points.begin(), points.end(), cached.begin())) {
+                matches = false;
+            }
+        }
+    });
+    return matches;
+}
+
+bool Deck::isPlayableDeck(int order, int threadCount) const {
+    // Init takes the card size from line 0 and GetCommonImage merges sorted cards, which must have a common image
+    if (table_.GetLineCount() == 0) {
+        return false;
+    }
+    for (int line = 0; line < table_.GetLineCount(); ++line) {
+        IndexSpan points = table_.GetLine(line);
+        if (points.size() != order + 1 || !is_sorted(points.begin(), points.end())) {
+            return false;
+        }
+    }
+    return DeckValidator::IsValid(table_, threadCount);
+}
+
+void Deck::initSearchedDeck(int order, DeckCache& cache, int threadCount) {
+    plane_.reset();
+    // the checksum catches damaged files, a replaced or imported file must still be a deck the game can play
+    if (cache.Find(SEARCH_CACHE_BACKEND, order, table_) && isPlayableDeck(order, threadCount)) {
+        return;
+    }
+    cout << "no projective plane of order " << order << ", searching for the largest deck" << endl;
+    IncidenceTable searched = DeckSearch{order + 1, ProjectivePlane::GetSizeFromOrder(order)}
+            .Generate(SEARCH_TIME_BUDGET, static_cast<uint64_t>(order));
+    cout << "found deck with " << searched.GetLineCount() << " cards" << endl;
+    if (!cache.Store(SEARCH_CACHE_BACKEND, order, searched, table_)) {
+        table_ = std::move(searched);
+    }
+}
 
-    for (auto&& line : linesIdx) {
-        Card card {};
-        for (auto&& imgIndex : line) {
-            if (imgIndex > images.size()) {
-                cout << "invalid image index " << imgIndex << " - image count is: " << images.size() << endl;
-                throw std::exception{};
+void Deck::selectBalancedCards(Random& random) {
+    const IncidenceTable& table = table_;
+    int cardCount = selectedCardCount_;
+    int lineCount = table.GetLineCount();
+    int lineSize = table.GetLine(0).size();
+    int usedSymbolCount = 0;
+    for (int symbol = 0; symbol < table.GetPointCount(); ++symbol) {
+        usedSymbolCount += table.GetLinesThrough(symbol).size() > 0 ? 1 : 0;
+    }
+    // every 2 lines meet in 1 point, so the sum of squares of symbol counts is the same for any choice of cards,
+    // balance is measured by the sum of 4th powers of differences from the average count instead
+    double average = cardCount * (double)lineSize / usedSymbolCount;
+    auto cost = [average](int count) {
+        double difference = count - average;
+        return difference * difference * difference * difference;
+    };
+    // candidates are scanned in random order, so that ties are broken differently in every game,
+    // scratch vectors are members, so selecting cards again in the next game allocates nothing
+    vector<int>& candidates = selection_.Candidates_;
+    candidates.resize(lineCount);
+    iota(candidates.begin(), candidates.end(), 0);
+    for (int i = lineCount - 1; i >= 1; i--) {
+        swap(candidates[i], candidates[random.NextInt(i + 1)]);
+    }
+    vector<int>& symbolCount = selection_.SymbolCounts_;
+    symbolCount.assign(table.GetPointCount(), 0);
+    vector<bool>& selected = selection_.Selected_;
+    selected.assign(lineCount, false);
+    // change of cost after adding or removing a card, kept up to date for every line
+    vector<double>& addCost = selection_.AddCosts_;
+    addCost.assign(lineCount, lineSize * (cost(1) - cost(0)));
+    vector<double>& removeCost = selection_.RemoveCosts_;
+    removeCost.assign(lineCount, 0);
+    auto changeCard = [&](int card, int change) {
+        selected[card] = change > 0;
+        for (int symbol : table.GetLine(card)) {
+            int& count = symbolCount[symbol];
+            double addBefore = cost(count + 1) - cost(count);
+            double removeBefore = count > 0 ? cost(count - 1) - cost(count) : 0;
+            count += change;
+            double addAfter = cost(count + 1) - cost(count);
+            double removeAfter = count > 0 ? cost(count - 1) - cost(count) : 0;
+            for (int line : table.GetLinesThrough(symbol)) {
+                addCost[line] += addAfter - addBefore;
+                removeCost[line] += removeAfter - removeBefore;
+            }
+        }
+    };
+    for (int card = 0; card < cardCount; ++card) {
+        int best = -1;
+        for (int line : candidates) {
+            if (!selected[line] && (best == -1 || addCost[line] < addCost[best])) {
+                best = line;
             }
+        }
+        changeCard(best, 1);
+    }
+    // greedy choice can leave some symbols overused, swap cards while it lowers the cost
+    // (the common symbol of the swapped cards does not change, so the real cost change is even lower)
+    for (int swaps = 0; swaps < lineCount; ++swaps) {
+        int removed = -1;
+        int added = -1;
+        for (int line : candidates) {
+            if (selected[line] && (removed == -1 || removeCost[line] < removeCost[removed])) {
+                removed = line;
+            } else if (!selected[line] && (added == -1 || addCost[line] < addCost[added])) {
+                added = line;
+            }
+        }
+        if (added == -1 || removeCost[removed] + addCost[added] >= 0) {
+            break;
+        }
+        changeCard(removed, -1);
+        changeCard(added, 1);
+    }
+    cardOrder_.clear();
+    for (int line = 0; line < lineCount; ++line) {
+        if (selected[line]) {
+            cardOrder_.push_back(line);
+        }
+    }
+}
 
-            card.AddImage(images[imgIndex]);
+Card Deck::createCard(int line) {
+    size_t first = symbols_.size();
+    if (table_.GetLineCount() > 0) {
+        addSymbols(table_.GetLine(line));
+    } else {
+        vector<int> points = plane_->GetLine(line);
+        addSymbols(IndexSpan{points.data(), points.data() + points.size()});
+    }
+    Point equation = plane_ ? plane_->GetLineEquation(line) : Point{0, 0, 0};
+    return Card{line, equation, symbols_.data() + first, lineSize_};
+}
+
+void Deck::addSymbols(IndexSpan points) {
+    // everything is checked before adding, so that the table of symbols never grows over its capacity
+    if (points.size() != lineSize_) {
+        throw logic_error("All cards of the deck must have the same number of symbols");
+    }
+    for (int imgIndex : points) {
+        if (imgIndex < 0 || imgIndex >= static_cast<int>(images_->size())) {
+            cout << "invalid image index " << imgIndex << " - image count is: " << images_->size() << endl;
+            throw std::exception{};
         }
-        cards_.push_back(card);
+    }
+    for (int imgIndex : points) {
+        symbols_.push_back(static_cast<SymbolId>(imgIndex));
     }
 }
 
-void Deck::Shuffle() {
+SymbolId Deck::GetCommonImage(const Card* card1, const Card* card2) const {
+    if (plane_) {
+        return static_cast<SymbolId>(plane_->GetCommonPoint(card1->Equation_, card2->Equation_));
+    }
+    // searched decks have symbols of every card sorted, find the common one by merging
+    int idx1 = 0;
+    int idx2 = 0;
+    while (idx1 < card1->GetSymbolCount() && idx2 < card2->GetSymbolCount()) {
+        SymbolId symbol1 = card1->GetSymbol(idx1);
+        SymbolId symbol2 = card2->GetSymbol(idx2);
+        if (symbol1 == symbol2) {
+            return symbol1;
+        }
+        symbol1 < symbol2 ? idx1++ : idx2++;
+    }
+    throw logic_error("Cards have no common symbol");
+}
+
+void Deck::Shuffle(Random& random) {
     // Fisher–Yates shuffle
-    for (int i = cards_.size() - 1; i >= 1; i--) {
-        int j = rand() % (i + 1);
-        auto card = cards_[i];
-        cards_[i] = cards_[j];
-        cards_[j] = card;
+    for (int i = cardOrder_.size() - 1; i >= 1; i--) {
+        int j = random.NextInt(i + 1);
+        swap(cardOrder_[i], cardOrder_[j]);
+    }
+}
+
+void Deck::Reset(Random& random) {
+    if (selectedCardCount_ > 0) {
+        selectBalancedCards(random);
+    }
+    Shuffle(random);
+    topCardIdx_ = 0;
+    if (shownPairs_ != nullptr) {
+        updateLinePositions();
+        shownPairs_->Reset();
     }
 }
 
@@ -51,15 +270,53 @@ Card* Deck::GetNextCard() {
     }
     int returnIdx = topCardIdx_;
     topCardIdx_++;
-    return &cards_[returnIdx];
+    return openCard(returnIdx);
+}
+
+Card* Deck::GetPartnerCard(Card*& kept, Random& random) {
+    int cardCount = static_cast<int>(cardOrder_.size());
+    if (shownPairs_ == nullptr) {
+        shownPairs_ = make_unique<PairTracker>(cardCount);
+        updateLinePositions();
+    }
+    if (shownPairs_->GetUnvisitedPairCount() == 0) {
+        Shuffle(random);
+        updateLinePositions();
+        shownPairs_->Reset();
+    }
+    int keptPosition = linePositions_[kept->Id_];
+    int position = shownPairs_->FindUnvisitedPartner(keptPosition, random.NextInt(cardCount));
+    if (position == -1) {
+        keptPosition = shownPairs_->FindItemWithUnvisitedPartner(random.NextInt(cardCount));
+        kept = openCard(keptPosition);
+        position = shownPairs_->FindUnvisitedPartner(keptPosition, random.NextInt(cardCount));
+    }
+    shownPairs_->Visit(keptPosition, position);
+    return openCard(position);
+}
+
+Card* Deck::openCard(int position) {
+    int line = cardOrder_[position];
+    if (cards_[line].GetSymbolCount() == 0) {
+        cards_[line] = createCard(line);
+    }
+    return &cards_[line];
+}
+
+void Deck::updateLinePositions() {
+    int lineCount = table_.GetLineCount() > 0 ? table_.GetLineCount() : plane_->GetPointCount();
+    linePositions_.assign(lineCount, -1);
+    for (int position = 0; position < static_cast<int>(cardOrder_.size()); ++position) {
+        linePositions_[cardOrder_[position]] = position;
+    }
 }
 
 int Deck::GetRemainingCardsCount() {
-    return cards_.size() - topCardIdx_;
+    return cardOrder_.size() - topCardIdx_;
 }
 
 int Deck::GetTotalCardsCount() {
-    return cards_.size();
+    return cardOrder_.size();
 }
 
 
@@ -70,8 +327,6 @@ void Game::Init() {
     CardsTotal_ = 0;
     Screen_ = make_unique<IntroScreen>(this, Width_, Height_, Renderer_);
     Screen_->Init();
-    HeartImage_ = ImageLoader::LoadSurface("./data/assets/heart.png");
-    srand(time(nullptr)); // seed based on time
 }
 
 void Game::Update() {
@@ -96,6 +351,9 @@ void Game::Draw() const {
 }
 
 void Game::StartPlay() {
+    // every game gets its own seed, so that a new game does not repeat the previous one
+    gameCount_++;
+    gameSeed_ = Random{Seed_, static_cast<uint64_t>(gameCount_)}.Next();
     Screen_ = make_unique<PlayScreen>(this, Width_, Height_, Renderer_);
     Screen_->Init();
     State_ = Playing;
@@ -130,6 +388,11 @@ long Game::GetRemainingTime() const {
     return timeRemaining_;
 }
 
+long Game::GetTimeToNextUpdate() const {
+    // remaining time is displayed in whole seconds, it changes when it drops below the current second
+    return State_ == Playing ? timeRemaining_ % 1000 + 1 : -1;
+}
+
 int Game::GetLives() const {
     return lives_;
 }
@@ -153,36 +416,61 @@ int Game::GetCardsDone() const {
     return cardsDone_;
 }
 
+Deck& Game::GetDeck(Random& random) {
+    // decks are built once per configuration, new games only reshuffle them (and choose cards of partial decks again)
+    unique_ptr<Deck>& deck = decks_[{ImagesPerCard_, CardCount_}];
+    if (deck == nullptr) {
+        deck = make_unique<Deck>();
+        deck->Init(Images_, ImagesPerCard_, DeckCache_, CardCount_, random);
+    }
+    return *deck;
+}
+
+void Game::ResetTextures(const vector<Image>& images) {
+    CardTextures_.Clear();
+    // images are updated in place, decks and rendered cards point to them
+    for (size_t i = 0; i < Images_.size() && i < images.size(); ++i) {
+        Images_[i].Texture_ = images[i].Texture_;
+        Images_[i].TextureRect_ = images[i].TextureRect_;
+    }
+}
+
+Random Game::CreateRandom(RandomStream stream) const {
+    return Random{gameSeed_, static_cast<uint64_t>(stream)};
+}
+
 void PlayScreen::Init() {
-    deck_.Init(Game_->Images_, Game_->ImagesPerCard_);
-    deck_.Shuffle();
-    Game_->CardsTotal_ = deck_.GetTotalCardsCount();
+    deckRandom_ = Game_->CreateRandom(RandomStream::Deck);
+    deck_ = &Game_->GetDeck(deckRandom_);
+    deck_->Reset(deckRandom_);
+    layoutRandom_ = Game_->CreateRandom(RandomStream::Layout);
+    Game_->CardsTotal_ = deck_->GetTotalCardsCount();
     int circleWidth = Width_ / 2 - 2 * CARD_PADDING;
     cardRadius_ = circleWidth / 2;
     leftCardCenterX_ = 2 * CARD_PADDING + cardRadius_;
     rightCardCenterX_ = leftCardCenterX_ + circleWidth + CARD_PADDING;
     cardCenterY_ = Height_ - CARD_PADDING - cardRadius_;
-    Card* left = deck_.GetNextCard();
-    Card* right = deck_.GetNextCard();
-    leftCard_ = RenderedCard{left, leftCardCenterX_, cardCenterY_, cardRadius_};
-    rightCard_ = RenderedCard{right, rightCardCenterX_, cardCenterY_, cardRadius_};
-    leftCard_.Init();
-    rightCard_.Init();
-    result_ = leftCard_.GetCommon(rightCard_);
+    Card* left = deck_->GetNextCard();
+    Card* right = Game_->Endless_ ? deck_->GetPartnerCard(left, deckRandom_) : deck_->GetNextCard();
+    leftCard_ = RenderedCard{left, &Game_->Images_, leftCardCenterX_, cardCenterY_, cardRadius_};
+    rightCard_ = RenderedCard{right, &Game_->Images_, rightCardCenterX_, cardCenterY_, cardRadius_};
+    leftCard_.Init(layoutRandom_);
+    rightCard_.Init(layoutRandom_);
+    result_ = deck_->GetCommonImage(left, right);
 }
 
 void PlayScreen::Draw() {
     drawBackground();
     // draw pictures on the cards
-    leftCard_.Draw(Renderer_);
-    rightCard_.Draw(Renderer_);
+    leftCard_.Draw(Renderer_, Game_->CardTextures_);
+    rightCard_.Draw(Renderer_, Game_->CardTextures_);
 
     SDL_RenderPresent(Renderer_);
 
 }
 
 void PlayScreen::UpdateOnClick(int mouseX, int mouseY) {
-    Image* image;
+    const Image* image;
     if (mouseX < Width_ / 2) {
         image = leftCard_.GetClickedImage(mouseX, mouseY);
     } else {
@@ -191,9 +479,10 @@ void PlayScreen::UpdateOnClick(int mouseX, int mouseY) {
     if (image == nullptr) {
         return;
     }
+    // symbols are compared by their IDs, names are needed only for the log
     cout << "image clicked: " << image->Name_ << endl;
-    if (image->Name_ == result_) {
-        cout << "result: " << result_ << endl;
+    if (image->Id_ == result_) {
+        cout << "result: " << image->Name_ << endl;
         Game_->MarkSolvedCard();
         prepareNextCard();
     } else {
@@ -203,17 +492,24 @@ void PlayScreen::UpdateOnClick(int mouseX, int mouseY) {
 }
 
 void PlayScreen::prepareNextCard() {
-    if (deck_.GetRemainingCardsCount() == 0) {
+    if (deck_->GetRemainingCardsCount() == 0 && !Game_->Endless_) {
         Game_->EndGame();
         return;
     }
-    auto newRight = leftCard_.GetCard();
-    auto newLeft = deck_.GetNextCard();
-    leftCard_ = RenderedCard{newLeft, leftCardCenterX_, cardCenterY_, cardRadius_};
-    rightCard_ = RenderedCard{newRight, rightCardCenterX_, cardCenterY_, cardRadius_};
-    leftCard_.Init();
-    rightCard_.Init();
-    result_ = leftCard_.GetCommon(rightCard_);
+    Card* kept = leftCard_.GetCard();
+    auto newLeft = Game_->Endless_ ? deck_->GetPartnerCard(kept, deckRandom_) : deck_->GetNextCard();
+    if (kept == leftCard_.GetCard()) {
+        // the card keeps its layout and rendered texture, only the new card is rendered
+        rightCard_ = std::move(leftCard_);
+        rightCard_.SetCenter(rightCardCenterX_, cardCenterY_);
+    } else {
+        // endless mode replaced the card, that should move
+        rightCard_ = RenderedCard{kept, &Game_->Images_, rightCardCenterX_, cardCenterY_, cardRadius_};
+        rightCard_.Init(layoutRandom_);
+    }
+    leftCard_ = RenderedCard{newLeft, &Game_->Images_, leftCardCenterX_, cardCenterY_, cardRadius_};
+    leftCard_.Init(layoutRandom_);
+    result_ = deck_->GetCommonImage(newLeft, kept);
 }
 
 void PlayScreen::drawBackground() {
@@ -222,18 +518,15 @@ void PlayScreen::drawBackground() {
     auto windowRect = SDL_Rect{0, 0, Width_, Height_};
     SDL_RenderFillRect(Renderer_, &windowRect);
 
-    // display outline of the deck under the left card
-    int deckCount = deck_.GetRemainingCardsCount();
+    // display outline of the deck under the left card, the cards themselves are drawn with their images
+    int deckCount = deck_->GetRemainingCardsCount();
     int outlineCount = deckCount >= MAX_CARDS_DISPLAYED ? MAX_CARDS_DISPLAYED : deckCount;
-    for (int i = outlineCount; i >= 0; i--) {
+    for (int i = outlineCount; i > 0; i--) {
         filledCircleRGBA(Renderer_, (short)(leftCardCenterX_ - (CARD_PADDING / MAX_CARDS_DISPLAYED) * i), cardCenterY_,
                          cardRadius_, white_.r, white_.g, white_.b, white_.a); // first white circle
         circleRGBA(Renderer_, (short)(leftCardCenterX_ - (CARD_PADDING / MAX_CARDS_DISPLAYED) * i), cardCenterY_,
                    cardRadius_, black_.r, black_.g, black_.b, black_.a); // first circle black border
     }
-    // right card
-    filledCircleRGBA(Renderer_, rightCardCenterX_, cardCenterY_, cardRadius_, white_.r, white_.g, white_.b, white_.a); // second white circle
-    circleRGBA(Renderer_, rightCardCenterX_, cardCenterY_, cardRadius_, black_.r, black_.g, black_.b, black_.a); // second circle black border
 
     drawHeader();
 }
@@ -269,12 +562,11 @@ void PlayScreen::drawHeader() {
 
     int heartPadding = 10;
     int lives = Game_->GetLives();
-    double scale = 20 / (double)Game_->HeartImage_->w;
-    auto scaled = rotozoomSurface(Game_->HeartImage_, 0, scale, SMOOTHING_OFF);
-    auto texture = SDL_CreateTextureFromSurface(Renderer_, scaled);
+    const Image* heart = Game_->HeartImage_;
+    int heartHeight = HEART_SIZE * heart->TextureRect_.h / heart->TextureRect_.w;
     for (int i = 0; i < lives; ++i) {
-        SDL_Rect destRect{textLivesX + 60 + i* scaled->w + i*heartPadding, textY, scaled->w, scaled->h };
-        SDL_RenderCopy(Renderer_, texture, NULL, &destRect);
+        SDL_Rect destRect{textLivesX + 60 + i* HEART_SIZE + i*heartPadding, textY, HEART_SIZE, heartHeight };
+        SDL_RenderCopy(Renderer_, heart->Texture_, &heart->TextureRect_, &destRect);
     }
 
 
@@ -5,11 +5,14 @@
 #ifndef COBBLE_SRC_COBBLE_H
 #define COBBLE_SRC_COBBLE_H
 
+#include "deck_cache.h"
 #include "image_loader.h"
 #include "graphic_utils.h"
 #include "screen_components.h"
 #include "card.h"
+#include "random.h"
 
+#include <cstdint>
 #include <utility>
 #include <vector>
 #include <map>
@@ -38,10 +41,14 @@ public:
      * @param renderer Renderer used to draw on screen
      * @param imagesPerCard Number of images per card
      * @param images List of images used in the game
+     * @param cardCount Number of cards in the deck, 0 for the full deck
+     * @param seed Seed of all random numbers in the session
+     * @param endless Whether the deck is reshuffled instead of ending the game
      */
-    Game(int width, int height, SDL_Renderer* renderer, int imagesPerCard, std::vector<Image> images)
+    Game(int width, int height, SDL_Renderer* renderer, int imagesPerCard, std::vector<Image> images, int cardCount,
+         uint64_t seed, bool endless)
         : Width_(width), Height_(height), Renderer_(renderer), ImagesPerCard_(imagesPerCard), Images_(std::move(images)),
-            State_(Intro) {}
+            State_(Intro), CardCount_(cardCount), Seed_(seed), Endless_(endless) {}
     /**
      * State of the game
      */
@@ -62,6 +69,10 @@ public:
      * Number of images per card
      */
     int ImagesPerCard_;
+    /**
+     * Number of cards in the deck, 0 for the full deck
+     */
+    int CardCount_;
     /**
      * List of images used in the game
      */
@@ -70,7 +81,26 @@ public:
      * Renderer used to draw on screen
      */
     SDL_Renderer* Renderer_;
-    SDL_Surface* HeartImage_;
+    /**
+     * Image of a life, it must be set before Init
+     */
+    const Image* HeartImage_ = nullptr;
+    /**
+     * Cache of generated card decks
+     */
+    DeckCache DeckCache_{"./data/cache"};
+    /**
+     * Rendered cards, kept across card moves and games, it must be cleared before the renderer is destroyed
+     */
+    CardTextureCache CardTextures_{};
+    /**
+     * Seed of all random numbers in the session, every game derives its own seed from it
+     */
+    uint64_t Seed_;
+    /**
+     * Endless mode - deck is reshuffled instead of ending the game, no pair of cards repeats before all pairs were shown
+     */
+    bool Endless_;
     /**
      * Total number of cards in the card deck
      */
@@ -115,10 +145,39 @@ public:
      * @return remaining time in milliseconds
      */
     long GetRemainingTime() const;
+    /**
+     * Get time until the screen changes without input, i.e. until the displayed remaining time changes
+     * @return time in milliseconds, -1 if the screen does not change without input
+     */
+    long GetTimeToNextUpdate() const;
+    /**
+     * Use textures of images rebuilt after the renderer lost all textures (SDL_RENDER_DEVICE_RESET),
+     * rendered cards are dropped and rendered again
+     * @param images Images with new textures, in the same order as images of the game
+     */
+    void ResetTextures(const std::vector<Image>& images);
     /**
      * Update based on solved card
      */
     void MarkSolvedCard();
+    /**
+     * Create generator of random numbers for a part of the current game
+     *
+     * Generators depend only on the session seed, number of the game and the stream,
+     * so the same seed replays the same shuffles and layouts.
+     * @param stream Part of the game using the generator
+     * @return New generator
+     */
+    Random CreateRandom(RandomStream stream) const;
+    /**
+     * Get deck for the current configuration
+     *
+     * Deck is built when it is needed for the first time and kept for the life of the game,
+     * so starting a new game only needs to reset it.
+     * @param random Generator of random numbers used to build the deck
+     * @return Deck, not shuffled
+     */
+    Deck& GetDeck(Random& random);
     /**
      * Get the current amount of points
      * @return points
@@ -139,6 +198,9 @@ private:
     int lives_;
     int points_;
     int cardsDone_;
+    int gameCount_ = 0;
+    uint64_t gameSeed_ = 0;
+    std::map<std::pair<int, int>, std::unique_ptr<Deck>> decks_{}; // decks by images per card and number of cards
 };
 
 /**
@@ -256,14 +318,17 @@ public:
 private:
     static const short CARD_PADDING = 25;
     static const int MAX_CARDS_DISPLAYED = 4;
-    Deck deck_{};
+    static const int HEART_SIZE = 20;
+    Deck* deck_ = nullptr; // owned by the game
+    Random deckRandom_{0};
+    Random layoutRandom_{0};
     RenderedCard leftCard_;
     RenderedCard rightCard_;
     short leftCardCenterX_;
     short rightCardCenterX_;
     short cardCenterY_;
     short cardRadius_;
-    std::string result_;
+    SymbolId result_ = 0; // ID of the common symbol of the displayed cards
     void prepareNextCard();
     void drawBackground();
     void drawHeader();
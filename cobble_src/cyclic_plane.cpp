@@ -0,0 +1,92 @@
+#include "cyclic_plane.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+CyclicPlane::CyclicPlane(int order) : n_(order), pointCount_(order * order + order + 1) {
+    findDifferenceSet();
+    buildDifferenceTable();
+}
+
+void CyclicPlane::GetLine(int line, int* points) const {
+    for (int d : differenceSet_) {
+        int point = d + line;
+        *points++ = point >= pointCount_ ? point - pointCount_ : point;
+    }
+}
+
+int CyclicPlane::GetCommonPoint(int line1, int line2) const {
+    // d1 + line1 = d2 + line2, so d1 - d2 = line2 - line1
+    int difference = line2 - line1;
+    int d1 = differenceTable_[difference < 0 ? difference + pointCount_ : difference];
+    int point = d1 + line1;
+    return point >= pointCount_ ? point - pointCount_ : point;
+}
+
+IncidenceTable CyclicPlane::Generate() const {
+    IncidenceTable table{pointCount_, pointCount_, IncidenceTable::GetIncidenceCount(pointCount_, n_ + 1)};
+    for (int line = 0; line < pointCount_; ++line) {
+        GetLine(line, table.AddLine(n_ + 1));
+    }
+    table.BuildPointIndex();
+    return table;
+}
+
+void CyclicPlane::findDifferenceSet() {
+    GaloisField field{n_};
+    // x^3 = c2*x^2 + c1*x + c0, c0 must be non-zero so that x is invertible
+    // c0 changes fastest, since it has to be a generator of GF(n)* modulo cubes for x to work
+    for (int c2 = 0; c2 < n_; ++c2) {
+        for (int c1 = 0; c1 < n_; ++c1) {
+            for (int c0 = 1; c0 < n_; ++c0) {
+                if (tryPolynomial(field, c0, c1, c2)) {
+                    return;
+                }
+            }
+        }
+    }
+    throw logic_error("No perfect difference set found");
+}
+
+bool CyclicPlane::tryPolynomial(const GaloisField& field, int c0, int c1, int c2) {
+    differenceSet_.clear();
+    // x^i = v0 + v1*x + v2*x^2
+    int v0 = 1;
+    int v1 = 0;
+    int v2 = 0;
+    for (int i = 0; i < pointCount_; ++i) {
+        if (i > 0 && v1 == 0 && v2 == 0) {
+            return false; // x^i is from GF(n), powers of x repeat too early
+        }
+        if (v2 == 0) {
+            if (static_cast<int>(differenceSet_.size()) == n_ + 1) {
+                return false;
+            }
+            differenceSet_.push_back(i);
+        }
+        // multiply by x
+        int top = v2;
+        v2 = field.Add(v1, field.Mul(top, c2));
+        v1 = field.Add(v0, field.Mul(top, c1));
+        v0 = field.Mul(top, c0);
+    }
+    return v1 == 0 && v2 == 0 && static_cast<int>(differenceSet_.size()) == n_ + 1;
+}
+
+void CyclicPlane::buildDifferenceTable() {
+    differenceTable_.assign(pointCount_, -1);
+    for (int d1 : differenceSet_) {
+        for (int d2 : differenceSet_) {
+            if (d1 == d2) {
+                continue;
+            }
+            int difference = d1 - d2;
+            difference = difference < 0 ? difference + pointCount_ : difference;
+            if (differenceTable_[difference] != -1) {
+                throw logic_error("Difference set is not perfect");
+            }
+            differenceTable_[difference] = d1;
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef COBBLE_SRC_CYCLIC_PLANE_H
+#define COBBLE_SRC_CYCLIC_PLANE_H
+
+#include "finite_field.h"
+#include "incidence.h"
+
+#include <vector>
+
+/**
+ * Projective plane stored as a perfect difference set (Singer construction)
+ *
+ * Every projective plane of prime power order n is cyclic:
+ * - points are numbers from Z_N, N = n^2 + n + 1
+ * - there is a set D of (n + 1) points (perfect difference set), such that every non-zero number in Z_N
+ *   is a difference d1 - d2 of exactly one pair of elements of D
+ * - line i is the set D + i (mod N)
+ *
+ * Finding D:
+ * - elements of GF(n^3) are polynomials of degree < 3 over GF(n), taken modulo a cubic polynomial
+ * - we look for a cubic polynomial, where powers x^0 .. x^(N-1) are pairwise different up to a factor from GF(n)
+ * - powers of x then correspond to points of the plane
+ * - D are the exponents i, where x^i has a zero coefficient at x^2 (points on a plane through origin in GF(n)^3)
+ *
+ * Only D and a table of differences is stored, which needs O(N) memory instead of O(N * n) for all lines.
+ * Any line is derived on demand, common point of 2 lines is found with one lookup into the difference table.
+ */
+class CyclicPlane {
+public:
+    /**
+     * Find the difference set of the plane
+     * @param order Order of the plane (must be a prime power)
+     */
+    explicit CyclicPlane(int order);
+    /**
+     * Get the perfect difference set D
+     * @return Points of line 0 in ascending order
+     */
+    const std::vector<int>& GetDifferenceSet() const {
+        return differenceSet_;
+    }
+    /**
+     * Compute points of a line.
+     * @param line Index of line
+     * @param points Place for (n + 1) indexes of points on the line
+     */
+    void GetLine(int line, int* points) const;
+    /**
+     * Get the common point of 2 different lines in O(1).
+     * @param line1 Index of first line
+     * @param line2 Index of second line
+     * @return Index of the common point
+     */
+    int GetCommonPoint(int line1, int line2) const;
+    /**
+     * Generate all lines of the plane.
+     * @return Incidence table of lines and points of the plane
+     */
+    IncidenceTable Generate() const;
+    int GetPointCount() const {
+        return pointCount_;
+    }
+    int GetLineCount() const {
+        return pointCount_;
+    }
+
+private:
+    int n_;
+    int pointCount_;
+    std::vector<int> differenceSet_{};
+    std::vector<int> differenceTable_{}; // differenceTable_[d1 - d2] = d1 for d1, d2 from D
+    void findDifferenceSet();
+    bool tryPolynomial(const GaloisField& field, int c0, int c1, int c2);
+    void buildDifferenceTable();
+};
+
+#endif //COBBLE_SRC_CYCLIC_PLANE_H
@@ -0,0 +1,225 @@
+#include "deck_cache.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static_assert(sizeof(int) == sizeof(int32_t), "Cache files store table data as 32 bit integers");
+
+/**
+ * Header of a cache file
+ */
+struct CacheHeader {
+    char magic[4];
+    int32_t version;
+    int32_t order;
+    int32_t lineCount;
+    int32_t pointCount;
+    int32_t incidenceCount;
+    uint32_t checksum;
+    int32_t reserved; // keeps data aligned to 8 bytes
+};
+
+static constexpr char CACHE_MAGIC[4] = {'C', 'B', 'D', 'K'};
+
+// FNV-1a hash of table data
+static uint32_t computeChecksum(const int* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    auto bytes = reinterpret_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size * sizeof(int); ++i) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// offsets must not decrease and must span all incidences, indexes must be smaller than count
+static bool isValidIndex(const int* offsets, int rowCount, const int* indexes, int incidenceCount, int count) {
+    if (offsets[0] != 0 || offsets[rowCount] != incidenceCount) {
+        return false;
+    }
+    for (int row = 0; row < rowCount; ++row) {
+        if (offsets[row + 1] < offsets[row]) {
+            return false;
+        }
+    }
+    for (int i = 0; i < incidenceCount; ++i) {
+        if (indexes[i] < 0 || indexes[i] >= count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// checks both halves of table data in the layout of IncidenceTable, so that views of the data never read out of it
+static bool isValidTable(const int* data, int lineCount, int pointCount, int incidenceCount) {
+    const int* lineOffsets = data;
+    const int* linePoints = lineOffsets + lineCount + 1;
+    const int* pointOffsets = linePoints + incidenceCount;
+    const int* pointLines = pointOffsets + pointCount + 1;
+    return isValidIndex(lineOffsets, lineCount, linePoints, incidenceCount, pointCount)
+           && isValidIndex(pointOffsets, pointCount, pointLines, incidenceCount, lineCount);
+}
+
+/**
+ * Read only memory mapping of a whole file
+ */
+class DeckCache::MappedFile {
+public:
+    explicit MappedFile(const string& filePath) {
+#ifdef _WIN32
+        file_ = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            return;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file_, &fileSize) || fileSize.QuadPart == 0) {
+            return;
+        }
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_ == nullptr) {
+            return;
+        }
+        data_ = MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+        size_ = data_ != nullptr ? static_cast<size_t>(fileSize.QuadPart) : 0;
+#else
+        int file = open(filePath.c_str(), O_RDONLY);
+        if (file < 0) {
+            return;
+        }
+        struct stat fileStat {};
+        if (fstat(file, &fileStat) == 0 && fileStat.st_size > 0) {
+            void* data = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_SHARED, file, 0);
+            if (data != MAP_FAILED) {
+                data_ = data;
+                size_ = static_cast<size_t>(fileStat.st_size);
+            }
+        }
+        close(file); // mapping stays valid after the file is closed
+#endif
+    }
+    ~MappedFile() {
+#ifdef _WIN32
+        if (data_ != nullptr) {
+            UnmapViewOfFile(data_);
+        }
+        if (mapping_ != nullptr) {
+            CloseHandle(mapping_);
+        }
+        if (file_ != INVALID_HANDLE_VALUE) {
+            CloseHandle(file_);
+        }
+#else
+        if (data_ != nullptr) {
+            munmap(data_, size_);
+        }
+#endif
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    const char* GetData() const {
+        return static_cast<const char*>(data_);
+    }
+    size_t GetSize() const {
+        return size_;
+    }
+private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#endif
+};
+
+DeckCache::DeckCache(std::string directory) : directory_(std::move(directory)) {}
+
+DeckCache::~DeckCache() = default;
+
+bool DeckCache::Find(const std::string& backend, int order, IncidenceTable& table) {
+    string filePath = getFilePath(backend, order);
+    auto opened = tables_.find(filePath);
+    if (opened != tables_.end()) {
+        table = opened->second.second;
+        return true;
+    }
+    auto file = make_unique<MappedFile>(filePath);
+    if (file->GetSize() < sizeof(CacheHeader)) {
+        return false;
+    }
+    CacheHeader header {};
+    memcpy(&header, file->GetData(), sizeof(CacheHeader));
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != VERSION || header.order != order) {
+        return false;
+    }
+    if (header.lineCount < 0 || header.pointCount < 0 || header.incidenceCount < 0) {
+        return false;
+    }
+    size_t dataSize = IncidenceTable::GetDataSize(header.lineCount, header.pointCount, header.incidenceCount);
+    if (file->GetSize() != sizeof(CacheHeader) + dataSize * sizeof(int)) {
+        return false;
+    }
+    auto data = reinterpret_cast<const int*>(file->GetData() + sizeof(CacheHeader));
+    if (computeChecksum(data, dataSize) != header.checksum) {
+        return false;
+    }
+    // checksum is easy to recompute for an edited file, so offsets and indexes are checked before they are used
+    if (!isValidTable(data, header.lineCount, header.pointCount, header.incidenceCount)) {
+        return false;
+    }
+    table = IncidenceTable{data, header.lineCount, header.pointCount, header.incidenceCount};
+    tables_.emplace(filePath, make_pair(std::move(file), table));
+    return true;
+}
+
+bool DeckCache::Store(const std::string& backend, int order, const IncidenceTable& generated, IncidenceTable& table) {
+    string filePath = getFilePath(backend, order);
+    tables_.erase(filePath);
+    error_code error;
+    fs::create_directories(directory_, error);
+    if (error) {
+        return false;
+    }
+    CacheHeader header {};
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = VERSION;
+    header.order = order;
+    header.lineCount = generated.GetLineCount();
+    header.pointCount = generated.GetPointCount();
+    header.incidenceCount = generated.GetIncidenceCount();
+    header.checksum = computeChecksum(generated.GetData(), generated.GetDataSize());
+    // write to temporary file first, so a partially written file is never found
+    string tempPath = filePath + ".tmp";
+    {
+        ofstream file{tempPath, ios::binary | ios::trunc};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(generated.GetData()), generated.GetDataSize() * sizeof(int));
+        if (!file.good()) {
+            return false;
+        }
+    }
+    fs::rename(tempPath, filePath, error);
+    if (error) {
+        fs::remove(tempPath, error);
+        return false;
+    }
+    return Find(backend, order, table);
+}
+
+std::string DeckCache::getFilePath(const std::string& backend, int order) const {
+    return (fs::path(directory_) / (backend + "_" + to_string(order) + ".bin")).string();
+}
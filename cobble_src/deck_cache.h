@@ -0,0 +1,61 @@
+#ifndef COBBLE_SRC_DECK_CACHE_H
+#define COBBLE_SRC_DECK_CACHE_H
+
+#include "incidence.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+/**
+ * Cache of generated incidence tables stored in binary files
+ *
+ * Every table is stored in file `<directory>/<backend>_<order>.bin`:
+ * - header: magic "CBDK", format version, order, number of lines, points and incidences, checksum of data
+ * - data of IncidenceTable in the same layout as in memory, as 32 bit integers
+ *
+ * Files are memory mapped instead of read, so opening a cached table costs only the page-ins of the data.
+ * Mapped tables stay open for the lifetime of the cache, so repeated requests for the same table cost nothing.
+ */
+class DeckCache {
+public:
+    /**
+     * Current version of the file format
+     */
+    static const int VERSION = 1;
+    /**
+     * @param directory Directory with cache files
+     */
+    explicit DeckCache(std::string directory);
+    ~DeckCache();
+    DeckCache(const DeckCache&) = delete;
+    DeckCache& operator=(const DeckCache&) = delete;
+    /**
+     * Find table in cache
+     *
+     * Files with wrong version, size or checksum are ignored, as well as files with offsets or indexes out of the table.
+     * @param backend Name of the generator which created the table
+     * @param order Order of the deck
+     * @param table Set to a read only view of the cached table if found
+     * @return true if the table was found
+     */
+    bool Find(const std::string& backend, int order, IncidenceTable& table);
+    /**
+     * Save table to cache
+     * @param backend Name of the generator which created the table
+     * @param order Order of the deck
+     * @param generated Table to save
+     * @param table Set to a read only view of the cached table if saved
+     * @return true if the table was saved
+     */
+    bool Store(const std::string& backend, int order, const IncidenceTable& generated, IncidenceTable& table);
+
+private:
+    class MappedFile;
+    std::string directory_;
+    std::map<std::string, std::pair<std::unique_ptr<MappedFile>, IncidenceTable>> tables_;
+    std::string getFilePath(const std::string& backend, int order) const;
+};
+
+#endif //COBBLE_SRC_DECK_CACHE_H
@@ -0,0 +1,70 @@
+#include "deck_generator.h"
+#include "cyclic_plane.h"
+#include "latin_plane.h"
+#include "projective_plane.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+class EquationGenerator : public DeckGenerator {
+public:
+    const char* GetName() const override {
+        return "equation";
+    }
+    IncidenceTable Generate(int order, int threadCount) const override {
+        return ProjectivePlane{order}.Generate(threadCount);
+    }
+};
+
+class ScanGenerator : public DeckGenerator {
+public:
+    const char* GetName() const override {
+        return "scan";
+    }
+    IncidenceTable Generate(int order, int /*threadCount*/) const override {
+        return ProjectivePlane{order}.GenerateByScan();
+    }
+};
+
+class CyclicGenerator : public DeckGenerator {
+public:
+    const char* GetName() const override {
+        return "cyclic";
+    }
+    IncidenceTable Generate(int order, int /*threadCount*/) const override {
+        return CyclicPlane{order}.Generate();
+    }
+};
+
+class LatinSquareGenerator : public DeckGenerator {
+public:
+    const char* GetName() const override {
+        return "latin";
+    }
+    IncidenceTable Generate(int order, int threadCount) const override {
+        return LatinSquarePlane{order}.Generate(threadCount);
+    }
+};
+
+}
+
+const vector<const DeckGenerator*>& DeckGenerator::GetAll() {
+    static const EquationGenerator equation{};
+    static const ScanGenerator scan{};
+    static const CyclicGenerator cyclic{};
+    static const LatinSquareGenerator latin{};
+    static const vector<const DeckGenerator*> generators{&equation, &scan, &cyclic, &latin};
+    return generators;
+}
+
+const DeckGenerator& DeckGenerator::Find(const string& name) {
+    for (const DeckGenerator* generator : GetAll()) {
+        if (name == generator->GetName()) {
+            return *generator;
+        }
+    }
+    throw invalid_argument("Unknown deck generator " + name);
+}
@@ -0,0 +1,50 @@
+#ifndef COBBLE_SRC_DECK_GENERATOR_H
+#define COBBLE_SRC_DECK_GENERATOR_H
+
+#include "incidence.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * Construction of a full deck (projective plane) of prime power order n
+ *
+ * All generators return the same incidence format: N = n^2 + n + 1 lines (cards) with n + 1 points (symbols) each.
+ * Planes of the same order are isomorphic, but every generator numbers points and lines in its own way,
+ * so tables of different generators must not be mixed - e.g. the deck cache keeps them under the generator name.
+ *
+ * Available generators:
+ * - "equation" - lines solved directly from their equations (ProjectivePlane::Generate), numbering of ProjectivePlane
+ * - "scan" - every point tested against every line equation (ProjectivePlane::GenerateByScan), O(N^2)
+ * - "cyclic" - lines are shifts of a perfect difference set (CyclicPlane)
+ * - "latin" - affine plane from mutually orthogonal Latin squares and the line at infinity (LatinSquarePlane)
+ */
+class DeckGenerator {
+public:
+    virtual ~DeckGenerator() = default;
+    /**
+     * Get name of the generator
+     * @return Name
+     */
+    virtual const char* GetName() const = 0;
+    /**
+     * Generate the plane
+     * @param order Order of the plane (must be a prime power)
+     * @param threadCount Number of threads, generators may use fewer
+     * @return Incidence table of lines and points of the plane
+     */
+    virtual IncidenceTable Generate(int order, int threadCount) const = 0;
+    /**
+     * Get all generators
+     * @return Generators in the order listed above
+     */
+    static const std::vector<const DeckGenerator*>& GetAll();
+    /**
+     * Find generator by name
+     * @param name Name of the generator
+     * @return Generator
+     */
+    static const DeckGenerator& Find(const std::string& name);
+};
+
+#endif //COBBLE_SRC_DECK_GENERATOR_H
@@ -0,0 +1,227 @@
+#include "deck_search.h"
+#include "random.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+/**
+ * One run of the search, builds a deck card by card until no card can be added
+ */
+class DeckSearch::Search {
+public:
+    // no deck has more cards than symbols, so bitsets of cards have a fixed size
+    Search(int symbolsPerCard, int symbolCount, Random& random)
+        : symbolsPerCard_(symbolsPerCard), symbolCount_(symbolCount), random_(random),
+          words_((symbolCount + 63) / 64),
+          symbolCards_((size_t)symbolCount * words_, 0), covered_(words_, 0) {}
+
+    void Build(int maxStepsPerCard, chrono::steady_clock::time_point deadline) {
+        deadline_ = deadline;
+        while (static_cast<int>(cards_.size()) < symbolCount_) {
+            chosen_.clear();
+            fill(covered_.begin(), covered_.end(), 0);
+            steps_ = maxStepsPerCard;
+            if (!extend()) {
+                return;
+            }
+            addCard();
+        }
+    }
+
+    const vector<vector<int>>& GetCards() const {
+        return cards_;
+    }
+
+    // start again from given cards
+    void Reset(const vector<vector<int>>& cards) {
+        cards_.clear();
+        fill(symbolCards_.begin(), symbolCards_.end(), 0);
+        for (const auto& card : cards) {
+            chosen_ = card;
+            addCard();
+        }
+    }
+
+private:
+    int symbolsPerCard_;
+    int symbolCount_;
+    Random& random_;
+    int words_;
+    vector<vector<int>> cards_{};
+    vector<uint64_t> symbolCards_; // bitset of cards containing each symbol
+    vector<int> chosen_{}; // symbols of the new card
+    vector<uint64_t> covered_; // bitset of cards sharing a symbol with the new card
+    int steps_ = 0;
+    chrono::steady_clock::time_point deadline_{};
+
+    const uint64_t* cardsWith(int symbol) const {
+        return symbolCards_.data() + (size_t)symbol * words_;
+    }
+
+    bool isUsable(int symbol) const {
+        const uint64_t* cards = cardsWith(symbol);
+        for (int word = 0; word < words_; ++word) {
+            if (cards[word] & covered_[word]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool isUnused(int symbol) const {
+        const uint64_t* cards = cardsWith(symbol);
+        for (int word = 0; word < words_; ++word) {
+            if (cards[word] != 0) {
+                return false;
+            }
+        }
+        return find(chosen_.begin(), chosen_.end(), symbol) == chosen_.end();
+    }
+
+    bool isCovered(int card) const {
+        return (covered_[card / 64] >> (card % 64)) & 1;
+    }
+
+    void toggleSymbol(int symbol) {
+        const uint64_t* cards = cardsWith(symbol);
+        for (int word = 0; word < words_; ++word) {
+            covered_[word] ^= cards[word];
+        }
+    }
+
+    // add symbols to the new card until it has 1 common symbol with every card
+    bool extend() {
+        if (--steps_ < 0 || (steps_ % 256 == 0 && chrono::steady_clock::now() > deadline_)) {
+            steps_ = -1;
+            return false;
+        }
+        // uncovered card with the fewest usable symbols, the new card must contain one of them
+        int remaining = symbolsPerCard_ - static_cast<int>(chosen_.size());
+        int uncoveredCount = 0;
+        int bestCard = -1;
+        vector<int> bestSymbols{};
+        vector<int> symbols{};
+        for (int card = 0; card < static_cast<int>(cards_.size()); ++card) {
+            if (isCovered(card)) {
+                continue;
+            }
+            uncoveredCount++;
+            symbols.clear();
+            for (int symbol : cards_[card]) {
+                if (isUsable(symbol)) {
+                    symbols.push_back(symbol);
+                }
+            }
+            if (bestCard == -1 || symbols.size() < bestSymbols.size()) {
+                bestCard = card;
+                bestSymbols.swap(symbols);
+                if (bestSymbols.empty()) {
+                    return false;
+                }
+            }
+        }
+        if (uncoveredCount == 0) {
+            return fillUnused(remaining);
+        }
+        if (remaining == 0) {
+            return false;
+        }
+        // symbols covering more cards leave more room on the card, ties are broken randomly
+        for (int i = static_cast<int>(bestSymbols.size()) - 1; i >= 1; i--) {
+            swap(bestSymbols[i], bestSymbols[random_.NextInt(i + 1)]);
+        }
+        stable_sort(bestSymbols.begin(), bestSymbols.end(), [this](int symbol1, int symbol2) {
+            return cardCount(symbol1) > cardCount(symbol2);
+        });
+        for (int symbol : bestSymbols) {
+            chosen_.push_back(symbol);
+            toggleSymbol(symbol);
+            if (extend()) {
+                return true;
+            }
+            toggleSymbol(symbol);
+            chosen_.pop_back();
+        }
+        return false;
+    }
+
+    bool fillUnused(int remaining) {
+        for (int symbol = 0; symbol < symbolCount_ && remaining > 0; ++symbol) {
+            if (isUnused(symbol)) {
+                chosen_.push_back(symbol);
+                remaining--;
+            }
+        }
+        return remaining == 0;
+    }
+
+    int cardCount(int symbol) const {
+        int count = 0;
+        const uint64_t* cards = cardsWith(symbol);
+        for (int word = 0; word < words_; ++word) {
+            for (uint64_t bits = cards[word]; bits != 0; bits &= bits - 1) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    void addCard() {
+        int card = static_cast<int>(cards_.size());
+        sort(chosen_.begin(), chosen_.end());
+        for (int symbol : chosen_) {
+            symbolCards_[(size_t)symbol * words_ + card / 64] |= uint64_t{1} << (card % 64);
+        }
+        cards_.push_back(chosen_);
+    }
+};
+
+DeckSearch::DeckSearch(int symbolsPerCard, int symbolCount)
+        : symbolsPerCard_(symbolsPerCard), symbolCount_(symbolCount) {
+    if (symbolsPerCard < 2 || symbolCount < symbolsPerCard) {
+        throw invalid_argument("Deck needs at least 2 symbols per card and enough symbols for 1 card");
+    }
+}
+
+IncidenceTable DeckSearch::Generate(chrono::milliseconds timeBudget, uint64_t seed) const {
+    auto deadline = chrono::steady_clock::now() + timeBudget;
+    Random random{seed};
+    Search search{symbolsPerCard_, symbolCount_, random};
+    vector<vector<int>> bestCards{};
+    vector<vector<int>> cards{};
+    int stepsWithoutImprovement = MAX_STEPS_WITHOUT_IMPROVEMENT;
+    do {
+        if (stepsWithoutImprovement >= MAX_STEPS_WITHOUT_IMPROVEMENT) {
+            // local search is stuck, start from scratch
+            cards.clear();
+            stepsWithoutImprovement = 0;
+        } else {
+            // local search - remove a few random cards and complete the deck again
+            int removedCount = 1 + random.NextInt(MAX_REMOVED_CARDS);
+            for (int i = 0; i < removedCount && !cards.empty(); ++i) {
+                swap(cards[random.NextInt(static_cast<int>(cards.size()))], cards.back());
+                cards.pop_back();
+            }
+        }
+        search.Reset(cards);
+        search.Build(MAX_STEPS_PER_CARD, deadline);
+        stepsWithoutImprovement++;
+        if (search.GetCards().size() > bestCards.size()) {
+            bestCards = search.GetCards();
+            stepsWithoutImprovement = 0;
+        }
+        // smaller decks are accepted too, so that the search can move away from a dead end
+        cards = search.GetCards();
+    } while (static_cast<int>(bestCards.size()) < symbolCount_ && chrono::steady_clock::now() < deadline);
+
+    int cardCount = static_cast<int>(bestCards.size());
+    IncidenceTable table{cardCount, symbolCount_, cardCount * symbolsPerCard_};
+    for (const auto& card : bestCards) {
+        copy(card.begin(), card.end(), table.AddLine(symbolsPerCard_));
+    }
+    table.BuildPointIndex();
+    return table;
+}
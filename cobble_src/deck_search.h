@@ -0,0 +1,55 @@
+#ifndef COBBLE_SRC_DECK_SEARCH_H
+#define COBBLE_SRC_DECK_SEARCH_H
+
+#include "incidence.h"
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Search for a deck where every 2 cards have exactly 1 symbol in common, for any number of symbols per card
+ *
+ * Projective planes exist only for (some) orders n, which are prime powers, for other orders the largest deck
+ * is not known, so it is searched for. Deck is built card by card:
+ * - every existing card must share exactly 1 symbol with the new card,
+ *   so the search branches on the symbols of the existing card with the fewest usable symbols
+ * - symbol is usable if none of the cards containing it is already covered by the new card,
+ *   cards containing every symbol are kept as bitsets, so this check is a few AND operations
+ * - when all existing cards are covered, the rest of the new card is filled with unused symbols
+ * Deck is complete, when no other card can be added. Search restarts with different random choices
+ * until the time budget runs out and returns the largest deck found.
+ */
+class DeckSearch {
+public:
+    /**
+     * @param symbolsPerCard Number of symbols on every card
+     * @param symbolCount Number of available symbols
+     */
+    DeckSearch(int symbolsPerCard, int symbolCount);
+    /**
+     * Search for the largest deck
+     * @param timeBudget Time after which the search stops
+     * @param seed Seed of random choices
+     * @return Incidence table of the largest deck found, symbols of every card in ascending order
+     */
+    IncidenceTable Generate(std::chrono::milliseconds timeBudget, uint64_t seed) const;
+
+private:
+    /**
+     * Maximal number of search steps spent on adding one card
+     */
+    static const int MAX_STEPS_PER_CARD = 10000;
+    /**
+     * Maximal number of cards removed from the deck in one step of local search
+     */
+    static const int MAX_REMOVED_CARDS = 3;
+    /**
+     * Number of local search steps without a larger deck, after which the search starts from scratch
+     */
+    static const int MAX_STEPS_WITHOUT_IMPROVEMENT = 200;
+    int symbolsPerCard_;
+    int symbolCount_;
+    class Search;
+};
+
+#endif //COBBLE_SRC_DECK_SEARCH_H
@@ -0,0 +1,92 @@
+#include "deck_validator.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+static inline int popCount(uint64_t word) {
+#if defined(_MSC_VER) && defined(_M_X64) && defined(__AVX__)
+    return static_cast<int>(__popcnt64(word));
+#elif defined(__POPCNT__)
+    return __builtin_popcountll(word);
+#else
+    // without the popcnt instruction the builtin is a library call, bit tricks are faster and vectorise
+    word = word - ((word >> 1) & 0x5555555555555555ull);
+    word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+    word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return static_cast<int>((word * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+vector<DeckValidator::InvalidPair> DeckValidator::Validate(const IncidenceTable& table, int threadCount, int maxReported) {
+    int cardCount = table.GetLineCount();
+    for (int card = 0; card < cardCount; ++card) {
+        for (int symbol : table.GetLine(card)) {
+            if (symbol < 0 || symbol >= table.GetPointCount()) {
+                throw invalid_argument("Symbol index out of range");
+            }
+        }
+    }
+    int words = (table.GetPointCount() + 63) / 64;
+    vector<uint64_t> bitsets = buildBitsets(table, words, threadCount);
+    vector<InvalidPair> invalidPairs{};
+    mutex invalidPairsMutex{};
+    // card i is compared with (cardCount - 1 - i) following cards, so every part takes cards
+    // from both ends of the deck to get the same number of pairs in each thread
+    Parallel::For(0, (cardCount + 1) / 2, threadCount, [&](int partBegin, int partEnd) {
+        vector<InvalidPair> partPairs{};
+        for (int i = partBegin; i < partEnd; ++i) {
+            checkCard(bitsets.data(), words, i, cardCount, partPairs, maxReported);
+            if (cardCount - 1 - i != i) {
+                checkCard(bitsets.data(), words, cardCount - 1 - i, cardCount, partPairs, maxReported);
+            }
+        }
+        if (!partPairs.empty()) {
+            lock_guard<mutex> lock{invalidPairsMutex};
+            invalidPairs.insert(invalidPairs.end(), partPairs.begin(), partPairs.end());
+        }
+    });
+    sort(invalidPairs.begin(), invalidPairs.end(), [](const InvalidPair& pair1, const InvalidPair& pair2) {
+        return pair1.Card1_ != pair2.Card1_ ? pair1.Card1_ < pair2.Card1_ : pair1.Card2_ < pair2.Card2_;
+    });
+    if (invalidPairs.size() > (size_t)maxReported) {
+        invalidPairs.resize(maxReported);
+    }
+    return invalidPairs;
+}
+
+vector<uint64_t> DeckValidator::buildBitsets(const IncidenceTable& table, int words, int threadCount) {
+    vector<uint64_t> bitsets((size_t)table.GetLineCount() * words, 0);
+    Parallel::For(0, table.GetLineCount(), threadCount, [&](int partBegin, int partEnd) {
+        for (int card = partBegin; card < partEnd; ++card) {
+            uint64_t* bitset = bitsets.data() + (size_t)card * words;
+            for (int symbol : table.GetLine(card)) {
+                bitset[symbol / 64] |= uint64_t{1} << (symbol % 64);
+            }
+        }
+    });
+    return bitsets;
+}
+
+void DeckValidator::checkCard(const uint64_t* bitsets, int words, int card, int cardCount,
+                              vector<InvalidPair>& invalidPairs, int maxReported) {
+    const uint64_t* bitset1 = bitsets + (size_t)card * words;
+    for (int other = card + 1; other < cardCount; ++other) {
+        const uint64_t* bitset2 = bitsets + (size_t)other * words;
+        // simple loop without early exit, so that the compiler can vectorise it
+        int commonCount = 0;
+        for (int word = 0; word < words; ++word) {
+            commonCount += popCount(bitset1[word] & bitset2[word]);
+        }
+        if (commonCount != 1 && invalidPairs.size() < (size_t)maxReported) {
+            invalidPairs.push_back({card, other, commonCount});
+        }
+    }
+}
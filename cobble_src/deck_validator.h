@@ -0,0 +1,65 @@
+#ifndef COBBLE_SRC_DECK_VALIDATOR_H
+#define COBBLE_SRC_DECK_VALIDATOR_H
+
+#include "incidence.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Check of the deck invariant: every 2 cards have exactly 1 symbol in common
+ *
+ * Every card is converted to a bitset of its symbols (one bit per symbol, 64 symbols per word).
+ * Number of common symbols of 2 cards is then the popcount of AND of their bitsets,
+ * which is a few instructions per word instead of intersecting 2 lists of symbols.
+ * Pairs of cards are split between threads, so even decks with millions of pairs are checked in milliseconds.
+ */
+class DeckValidator {
+public:
+    /**
+     * Maximal number of invalid pairs reported by default
+     */
+    static const int MAX_REPORTED_PAIRS = 100;
+    /**
+     * Pair of cards, which does not have exactly 1 common symbol
+     */
+    struct InvalidPair {
+        int Card1_;
+        int Card2_;
+        /**
+         * Number of symbols the cards have in common
+         */
+        int CommonCount_;
+    };
+    /**
+     * Check all pairs of cards of a deck
+     * @param table Incidence table of the deck, lines are cards and points are symbols
+     * @param threadCount Maximal number of threads
+     * @param maxReported Maximal number of returned invalid pairs
+     * @return Invalid pairs ordered by cards, empty if the deck is valid
+     * @throws std::invalid_argument if a card contains a symbol outside of the table
+     */
+    static std::vector<InvalidPair> Validate(const IncidenceTable& table, int threadCount = 1,
+                                             int maxReported = MAX_REPORTED_PAIRS);
+    /**
+     * Check that a deck is valid
+     * @param table Incidence table of the deck, lines are cards and points are symbols
+     * @param threadCount Maximal number of threads
+     * @return true if every 2 cards have exactly 1 common symbol and all symbols are inside of the table
+     */
+    static bool IsValid(const IncidenceTable& table, int threadCount = 1) {
+        try {
+            return Validate(table, threadCount, 1).empty();
+        } catch (const std::invalid_argument&) {
+            return false;
+        }
+    }
+
+private:
+    static std::vector<uint64_t> buildBitsets(const IncidenceTable& table, int words, int threadCount);
+    static void checkCard(const uint64_t* bitsets, int words, int card, int cardCount,
+                          std::vector<InvalidPair>& invalidPairs, int maxReported);
+};
+
+#endif //COBBLE_SRC_DECK_VALIDATOR_H
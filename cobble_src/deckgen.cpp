@@ -0,0 +1,294 @@
+#include "deck_generator.h"
+#include "deck_search.h"
+#include "deck_validator.h"
+#include "finite_field.h"
+#include "parallel.h"
+#include "projective_plane.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+/**
+ * Output formats of generated decks
+ */
+enum class DeckFormat {
+    Json,
+    Csv,
+    Binary,
+};
+
+/**
+ * Largest order of a generated deck, its incidence table must fit 32 bit offsets (see IncidenceTable::GetIncidenceCount)
+ */
+constexpr int MAX_ORDER = 1289;
+
+/**
+ * Class responsible for parsing options of the deck generator
+ */
+class DeckGenParser {
+public:
+    std::vector<int> Orders_{};
+    DeckFormat Format_ = DeckFormat::Json;
+    std::string OutputDir_ = ".";
+    int ThreadCount_ = Parallel::GetThreadCount();
+    std::chrono::milliseconds SearchTime_{2000};
+    const DeckGenerator* Generator_ = &DeckGenerator::Find("equation");
+    bool Validate_ = false;
+    /**
+     * Parse configuration
+     * @param arg command line arguments
+     */
+    void Parse(std::vector<std::string>& arg) {
+        for (size_t i = 1; i < arg.size(); ++i) {
+            if (arg[i] == "-v") {
+                Validate_ = true;
+            } else if (i + 1 < arg.size()) {
+                parseOption(arg[i], arg[i + 1]);
+                ++i;
+            } else {
+                throw std::invalid_argument("Missing value of option " + arg[i]);
+            }
+        }
+        if (Orders_.empty()) {
+            throw std::invalid_argument("No orders given");
+        }
+    }
+    /**
+     * Print help
+     */
+    static void Help() {
+        std::cout << "Usage:" << std::endl;
+        std::cout << "-n <orders> : orders of the decks, list of numbers and ranges, e.g. 2,3,5-9, at most " << MAX_ORDER << std::endl;
+        std::cout << "-f <format> : output format json, csv or bin (default json)" << std::endl;
+        std::cout << "-o <path> : output directory (default .)" << std::endl;
+        std::cout << "-t <number> : number of threads (default all cores)" << std::endl;
+        std::cout << "-b <generator> : generator of projective planes equation, scan, cyclic or latin (default equation)" << std::endl;
+        std::cout << "-s <milliseconds> : time to search for a deck, if order is not a prime power (default 2000)" << std::endl;
+        std::cout << "-v : check that every 2 cards of every deck have exactly 1 common symbol" << std::endl;
+    }
+private:
+    void parseOption(const std::string& option, const std::string& value) {
+        if (option == "-n") {
+            parseOrders(value);
+        } else if (option == "-f") {
+            parseFormat(value);
+        } else if (option == "-o") {
+            OutputDir_ = value;
+        } else if (option == "-t") {
+            ThreadCount_ = parseNumber(value, "Invalid value of option " + option + ": " + value);
+        } else if (option == "-b") {
+            Generator_ = &DeckGenerator::Find(value);
+        } else if (option == "-s") {
+            SearchTime_ = std::chrono::milliseconds{parseNumber(value, "Invalid value of option " + option + ": " + value)};
+        } else {
+            throw std::invalid_argument("Unknown option " + option);
+        }
+    }
+    // std::stoi reports bad numbers with its own messages (or out_of_range), they are replaced by message for the user
+    static int parseNumber(const std::string& value, const std::string& message) {
+        try {
+            return std::stoi(value);
+        } catch (const std::logic_error&) {
+            throw std::invalid_argument(message);
+        }
+    }
+    void parseOrders(const std::string& value) {
+        size_t start = 0;
+        while (start <= value.size()) {
+            size_t end = value.find(',', start);
+            std::string part = value.substr(start, end == std::string::npos ? std::string::npos : end - start);
+            size_t dash = part.find('-');
+            int first = parseNumber(part.substr(0, dash), "Invalid orders " + part);
+            int last = dash == std::string::npos ? first : parseNumber(part.substr(dash + 1), "Invalid orders " + part);
+            if (first < 1 || last < first) {
+                throw std::invalid_argument("Invalid orders " + part);
+            }
+            if (last > MAX_ORDER) {
+                throw std::invalid_argument("Invalid orders " + part + ", orders must be at most " + std::to_string(MAX_ORDER));
+            }
+            for (int order = first; order <= last; ++order) {
+                Orders_.push_back(order);
+            }
+            if (end == std::string::npos) {
+                break;
+            }
+            start = end + 1;
+        }
+    }
+    void parseFormat(const std::string& value) {
+        if (value == "json") {
+            Format_ = DeckFormat::Json;
+        } else if (value == "csv") {
+            Format_ = DeckFormat::Csv;
+        } else if (value == "bin") {
+            Format_ = DeckFormat::Binary;
+        } else {
+            throw std::invalid_argument("Unknown format " + value);
+        }
+    }
+};
+
+/**
+ * Generate deck of given order, projective plane (by the chosen generator) if it exists,
+ * otherwise the largest deck found by search
+ * @param order Order of the deck
+ * @param options Options of the generator
+ * @param threadCount Number of threads used to generate the deck
+ * @return Incidence table of the deck
+ */
+IncidenceTable generateDeck(int order, const DeckGenParser& options, int threadCount) {
+    if (GaloisField::IsPrimePower(order)) {
+        return options.Generator_->Generate(order, threadCount);
+    }
+    return DeckSearch{order + 1, ProjectivePlane::GetSizeFromOrder(order)}
+            .Generate(options.SearchTime_, static_cast<uint64_t>(order));
+}
+
+/**
+ * Write deck as JSON object with the order, number of symbols and list of cards
+ */
+void writeJson(std::ofstream& file, int order, const IncidenceTable& table) {
+    file << "{\"order\": " << order << ", \"symbolCount\": " << table.GetPointCount() << ", \"cards\": [";
+    for (int card = 0; card < table.GetLineCount(); ++card) {
+        file << (card > 0 ? ",\n  [" : "\n  [");
+        IndexSpan symbols = table.GetLine(card);
+        for (int i = 0; i < symbols.size(); ++i) {
+            file << (i > 0 ? ", " : "") << symbols[i];
+        }
+        file << "]";
+    }
+    file << "\n]}\n";
+}
+
+/**
+ * Write deck as CSV, one card per row
+ */
+void writeCsv(std::ofstream& file, const IncidenceTable& table) {
+    for (int card = 0; card < table.GetLineCount(); ++card) {
+        IndexSpan symbols = table.GetLine(card);
+        for (int i = 0; i < symbols.size(); ++i) {
+            file << (i > 0 ? "," : "") << symbols[i];
+        }
+        file << "\n";
+    }
+}
+
+/**
+ * Append little endian number to buffer
+ */
+void appendLittleEndian(std::vector<unsigned char>& buffer, uint32_t value, int bytes) {
+    for (int byte = 0; byte < bytes; ++byte) {
+        buffer.push_back(static_cast<unsigned char>(value >> (8 * byte)));
+    }
+}
+
+/**
+ * Write deck in compact binary form, all numbers are little endian
+ *
+ * Header: magic "CBDG" and 4 32 bit integers - order, number of cards, symbols per card, bytes per symbol.
+ * Header is followed by symbols of all cards, each stored in the smallest of 1, 2 or 4 bytes fitting all symbols.
+ */
+void writeBinary(std::ofstream& file, int order, const IncidenceTable& table) {
+    int cardCount = table.GetLineCount();
+    int symbolsPerCard = cardCount > 0 ? table.GetLine(0).size() : 0;
+    int symbolBytes = table.GetPointCount() <= 1 << 8 ? 1 : table.GetPointCount() <= 1 << 16 ? 2 : 4;
+    std::vector<unsigned char> buffer{'C', 'B', 'D', 'G'};
+    for (int value : {order, cardCount, symbolsPerCard, symbolBytes}) {
+        appendLittleEndian(buffer, static_cast<uint32_t>(value), 4);
+    }
+    for (int card = 0; card < cardCount; ++card) {
+        for (int symbol : table.GetLine(card)) {
+            appendLittleEndian(buffer, static_cast<uint32_t>(symbol), symbolBytes);
+        }
+        file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+        buffer.clear();
+    }
+    file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+}
+
+/**
+ * Write deck to file deck_<order>.<format> in the output directory
+ * @return Path to the file
+ */
+std::string writeDeck(int order, const IncidenceTable& table, const DeckGenParser& options) {
+    const char* extension = options.Format_ == DeckFormat::Json ? ".json" : options.Format_ == DeckFormat::Csv ? ".csv" : ".bin";
+    std::string filePath = (fs::path(options.OutputDir_) / ("deck_" + std::to_string(order) + extension)).string();
+    std::ofstream file{filePath, std::ios::binary};
+    if (!file.good()) {
+        throw std::runtime_error("Cannot open file " + filePath);
+    }
+    switch (options.Format_) {
+        case DeckFormat::Json:
+            writeJson(file, order, table);
+            break;
+        case DeckFormat::Csv:
+            writeCsv(file, table);
+            break;
+        case DeckFormat::Binary:
+            writeBinary(file, order, table);
+            break;
+    }
+    if (!file.good()) {
+        throw std::runtime_error("Cannot write file " + filePath);
+    }
+    return filePath;
+}
+
+//---------------------------------------------------------------------
+//  MAIN
+//  generates decks of many orders without starting the game
+//---------------------------------------------------------------------
+int main(int argc, char** argv) {
+    std::vector<std::string> arg(argv, argv + argc);
+    DeckGenParser options{};
+    try {
+        options.Parse(arg);
+    } catch (const std::invalid_argument& error) {
+        std::cout << error.what() << std::endl;
+        DeckGenParser::Help();
+        return 1;
+    }
+    std::error_code error;
+    fs::create_directories(options.OutputDir_, error);
+
+    // every thread takes the next order from the list, threads left over help to generate each plane
+    int orderCount = static_cast<int>(options.Orders_.size());
+    int threadCount = std::max(1, std::min(options.ThreadCount_, orderCount));
+    int threadsPerOrder = std::max(1, options.ThreadCount_ / orderCount);
+    std::atomic<int> nextOrder{0};
+    std::atomic<int> failedCount{0};
+    std::mutex outputMutex{};
+    Parallel::For(0, threadCount, threadCount, [&](int /*partBegin*/, int /*partEnd*/) {
+        for (int idx = nextOrder++; idx < orderCount; idx = nextOrder++) {
+            int order = options.Orders_[idx];
+            std::string message;
+            try {
+                IncidenceTable table = generateDeck(order, options, threadsPerOrder);
+                bool valid = !options.Validate_ || DeckValidator::IsValid(table, threadsPerOrder);
+                std::string filePath = writeDeck(order, table, options);
+                message = "order " + std::to_string(order) + ": " + std::to_string(table.GetLineCount()) + " cards"
+                        + (options.Validate_ ? (valid ? ", valid" : ", INVALID") : "") + " -> " + filePath;
+                if (!valid) {
+                    failedCount++;
+                }
+            } catch (const std::exception& exception) {
+                message = "order " + std::to_string(order) + ": " + exception.what();
+                failedCount++;
+            }
+            std::lock_guard<std::mutex> lock{outputMutex};
+            std::cout << message << std::endl;
+        }
+    });
+    return failedCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,230 @@
+#ifndef COBBLE_SRC_FINITE_FIELD_H
+#define COBBLE_SRC_FINITE_FIELD_H
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Finite (Galois) field GF(q) of prime power order q = p^k
+ *
+ * Representation:
+ * - elements are the integers 0 .. q-1
+ * - base p digits of an element are the coefficients of a polynomial of degree < k over Z_p
+ * - addition adds the polynomials coefficient by coefficient modulo p
+ * - multiplication is done modulo a primitive polynomial of degree k, found when the field is created
+ * - polynomial x then generates all non-zero elements, so every non-zero element is x^i for some i
+ * - multiplication and division are done with precomputed log/antilog tables
+ * - addition in fields with odd p and k > 1 uses a table of Zech logarithms: x^i + x^j = x^(i + Z(j - i)),
+ *   where x^Z(d) = 1 + x^d
+ *
+ * For k = 1 the field is Z_p and x is a primitive root modulo p.
+ *
+ * Tables are stored in a container of type Table. Fields created at runtime use std::vector (see GaloisField),
+ * fields with order known at compile time can use std::array and be built in constant expressions (see StaticGaloisField).
+ *
+ * @tparam Table Container for the log/antilog tables
+ */
+template<typename Table>
+class BasicGaloisField {
+public:
+    /**
+     * Create field and build its log/antilog tables in O(q)
+     * @param order Order of the field (must be a prime power)
+     */
+    constexpr explicit BasicGaloisField(int order) : q_(order) {
+        if (!IsPrimePower(order, p_, k_)) {
+            throw std::invalid_argument("Order of a finite field must be a prime power");
+        }
+        resizeTable(exp_, 2 * q_);
+        resizeTable(log_, q_);
+        resizeTable(zech_, q_);
+        buildTables();
+    }
+    /**
+     * Test if number is a power of a prime (p^k, k >= 1)
+     * @param number Tested number
+     * @param prime Set to p if number is a prime power
+     * @param exponent Set to k if number is a prime power
+     * @return true if number is a prime power
+     */
+    static constexpr bool IsPrimePower(int number, int& prime, int& exponent) {
+        if (number < 2) {
+            return false;
+        }
+        int divider = 2;
+        while (divider * divider <= number && number % divider != 0) {
+            divider++;
+        }
+        if (number % divider != 0) {
+            divider = number; // number is prime
+        }
+        int power = 0;
+        while (number % divider == 0) {
+            number /= divider;
+            power++;
+        }
+        prime = divider;
+        exponent = power;
+        return number == 1;
+    }
+    /**
+     * Test if number is a power of a prime (p^k, k >= 1)
+     * @param number Tested number
+     * @return true if number is a prime power
+     */
+    static constexpr bool IsPrimePower(int number) {
+        int prime = 0;
+        int exponent = 0;
+        return IsPrimePower(number, prime, exponent);
+    }
+    constexpr int GetOrder() const {
+        return q_;
+    }
+    constexpr int GetCharacteristic() const {
+        return p_;
+    }
+    constexpr int Add(int a, int b) const {
+        if (p_ == 2) {
+            return a ^ b;
+        }
+        if (k_ == 1) {
+            int sum = a + b;
+            return sum >= p_ ? sum - p_ : sum;
+        }
+        if (a == 0 || b == 0) {
+            return a + b;
+        }
+        int logA = log_[a];
+        int difference = log_[b] - logA;
+        int zech = zech_[difference < 0 ? difference + q_ - 1 : difference];
+        return zech < 0 ? 0 : exp_[logA + zech];
+    }
+    constexpr int Neg(int a) const {
+        if (p_ == 2) {
+            return a;
+        }
+        if (k_ == 1) {
+            return a == 0 ? 0 : p_ - a;
+        }
+        // -1 = x^((q-1)/2)
+        return a == 0 ? 0 : exp_[log_[a] + (q_ - 1) / 2];
+    }
+    constexpr int Sub(int a, int b) const {
+        return Add(a, Neg(b));
+    }
+    constexpr int Mul(int a, int b) const {
+        if (a == 0 || b == 0) {
+            return 0;
+        }
+        // antilog table is doubled, so the sum of logs needs no modulo
+        return exp_[log_[a] + log_[b]];
+    }
+    /**
+     * Multiplicative inverse
+     * @param a Non-zero element
+     * @return a^-1
+     */
+    constexpr int Inv(int a) const {
+        if (a == 0) {
+            throw std::invalid_argument("Zero has no inverse");
+        }
+        return exp_[q_ - 1 - log_[a]];
+    }
+    constexpr int Div(int a, int b) const {
+        return Mul(a, Inv(b));
+    }
+
+private:
+    int q_ = 0;
+    int p_ = 0;
+    int k_ = 0;
+    Table exp_{}; // exp_[i] = x^i, for i in 0 .. 2(q-1)
+    Table log_{}; // log_[x^i] = i
+    Table zech_{}; // x^zech_[d] = 1 + x^d, -1 if 1 + x^d = 0
+
+    template<typename T>
+    static void resizeTable(std::vector<T>& table, int size) {
+        table.assign(size, 0);
+    }
+    template<typename T, std::size_t Size>
+    static constexpr void resizeTable(std::array<T, Size>& /*table*/, int size) {
+        if (static_cast<int>(Size) < size) {
+            throw std::invalid_argument("Table is too small for the field");
+        }
+    }
+
+    // add polynomials coefficient by coefficient
+    constexpr int addDigits(int a, int b) const {
+        int result = 0;
+        for (int place = 1; a > 0 || b > 0; place *= p_) {
+            result += ((a % p_ + b % p_) % p_) * place;
+            a /= p_;
+            b /= p_;
+        }
+        return result;
+    }
+
+    // multiply every coefficient of polynomial a by scalar from Z_p
+    constexpr int scale(int a, int scalar) const {
+        int result = 0;
+        for (int place = 1; a > 0; place *= p_) {
+            result += (a % p_) * scalar % p_ * place;
+            a /= p_;
+        }
+        return result;
+    }
+
+    // multiply polynomial a by x modulo x^k - reduction
+    constexpr int mulByX(int a, int reduction, int topPlace) const {
+        int top = a / topPlace;
+        int shifted = (a % topPlace) * p_;
+        return addDigits(shifted, scale(reduction, top));
+    }
+
+    constexpr void buildTables() {
+        int topPlace = q_ / p_; // p^(k-1)
+        // try polynomials x^k - reduction until x generates all q-1 non-zero elements
+        for (int reduction = 1; reduction < q_; ++reduction) {
+            if (reduction % p_ == 0) {
+                continue; // x would be a zero divisor
+            }
+            int power = 1;
+            bool primitive = true;
+            for (int i = 0; i < q_ - 1; ++i) {
+                if (i > 0 && power == 1) {
+                    primitive = false;
+                    break;
+                }
+                exp_[i] = power;
+                power = mulByX(power, reduction, topPlace);
+            }
+            if (primitive && power == 1) {
+                for (int i = 0; i < q_ - 1; ++i) {
+                    exp_[i + q_ - 1] = exp_[i];
+                    log_[exp_[i]] = i;
+                }
+                for (int d = 0; d < q_ - 1; ++d) {
+                    int sum = addDigits(1, exp_[d]);
+                    zech_[d] = sum == 0 ? -1 : log_[sum];
+                }
+                return;
+            }
+        }
+        throw std::logic_error("No primitive polynomial found");
+    }
+};
+
+/**
+ * Finite field with tables allocated at runtime
+ */
+using GaloisField = BasicGaloisField<std::vector<int>>;
+
+/**
+ * Finite field of order Q, that can be created in constant expressions
+ */
+template<int Q>
+using StaticGaloisField = BasicGaloisField<std::array<int, 2 * Q>>;
+
+#endif //COBBLE_SRC_FINITE_FIELD_H
@@ -6,8 +6,24 @@
 #define COBBLE_SRC_GRAPHIC_UTILS_H
 
 #include "SDL_ttf.h"
+#include <cmath>
 #include <cstdio>
 #include <iostream>
+#include <memory>
+
+/**
+ * Deleter of SDL textures for smart pointers
+ */
+struct TextureDeleter {
+    void operator()(SDL_Texture* texture) const {
+        SDL_DestroyTexture(texture);
+    }
+};
+
+/**
+ * Texture destroyed together with its owner
+ */
+using TexturePtr = std::unique_ptr<SDL_Texture, TextureDeleter>;
 
 /**
  * Class containing multiple utilities for graphics ang text rendering
@@ -30,6 +46,24 @@ public:
         return false;
     }
 
+    /**
+     * Tests if the given point is inside the given rectangle rotated around its center.
+     * @param rect Rectangle before rotation
+     * @param angle Clockwise rotation in degrees (as in SDL_RenderCopyEx)
+     * @param x X coordinate of the tested point
+     * @param y Y coordinate of the tested point
+     * @return true if point is inside the rotated rectangle
+     */
+    static bool IsInRotatedRect(const SDL_Rect& rect, double angle, int x, int y) {
+        // rotate the point back around the center, then compare with the rectangle
+        double radians = angle * M_PI / 180;
+        double dx = x - (rect.x + rect.w / 2.0);
+        double dy = y - (rect.y + rect.h / 2.0);
+        double u = dx * cos(radians) + dy * sin(radians);
+        double v = -dx * sin(radians) + dy * cos(radians);
+        return fabs(u) <= rect.w / 2.0 && fabs(v) <= rect.h / 2.0;
+    }
+
     /**
      * Load font from file.
      * @param fontFile File with font in .TTF format
@@ -53,7 +87,7 @@ public:
      * @param size Size of the font
      * @param fgC Color of the text
      * @param bgC Color of the background
-     * @return Rendered text
+     * @return Rendered text, caller destroys the texture
      */
     static SDL_Texture* GetTextTexture(const std::string& fontFile, SDL_Renderer* renderer, const char* string, int size, SDL_Color fgC, SDL_Color bgC) {
         TTF_Font* font = GetFont(fontFile, size);
@@ -62,7 +96,7 @@ public:
         SDL_Surface* textSurface = TTF_RenderText_Shaded(font, string, fgC, bgC);   // anti-aliased glyphs
         TTF_CloseFont(font);
         SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, textSurface);
-        //        SDL_FreeSurface(textSurface);
+        SDL_FreeSurface(textSurface);
         return texture;
     }
 
@@ -79,11 +113,11 @@ public:
      */
     static void DrawText (const std::string& fontFile, SDL_Renderer* renderer, const char* string, int size, int x, int y, SDL_Color fgC, SDL_Color bgC) {
         // Remember to call TTF_Init(), TTF_Quit(), before/after using this function.
-        SDL_Texture* texture = GetTextTexture(fontFile, renderer, string, size, fgC, bgC);
+        TexturePtr texture{GetTextTexture(fontFile, renderer, string, size, fgC, bgC)};
         SDL_Point textureSize;
-        SDL_QueryTexture(texture, nullptr, nullptr, &textureSize.x, &textureSize.y);
+        SDL_QueryTexture(texture.get(), nullptr, nullptr, &textureSize.x, &textureSize.y);
         SDL_Rect textLocation = { x, y, textureSize.x, textureSize.y };
-        SDL_RenderCopy(renderer, texture, nullptr, &textLocation);
+        SDL_RenderCopy(renderer, texture.get(), nullptr, &textLocation);
     }
 
     /**
@@ -98,13 +132,13 @@ public:
      * @param bgC Color of the background
      */
     static void DrawTextCentered(const std::string& fontFile, SDL_Renderer* renderer, const char* string, int size, int centerX, int centerY, SDL_Color fgC, SDL_Color bgC) {
-        SDL_Texture* texture = GetTextTexture(fontFile, renderer, string, size, fgC, bgC);
+        TexturePtr texture{GetTextTexture(fontFile, renderer, string, size, fgC, bgC)};
         SDL_Point textureSize;
-        SDL_QueryTexture(texture, nullptr, nullptr, &textureSize.x, &textureSize.y);
+        SDL_QueryTexture(texture.get(), nullptr, nullptr, &textureSize.x, &textureSize.y);
         int topLeftX = centerX - textureSize.x / 2;
         int topLeftY = centerY - textureSize.y / 2;
         SDL_Rect textLocation = { topLeftX, topLeftY, textureSize.x, textureSize.y };
-        SDL_RenderCopy(renderer, texture, nullptr, &textLocation);
+        SDL_RenderCopy(renderer, texture.get(), nullptr, &textLocation);
     }
 };
 
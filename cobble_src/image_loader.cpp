@@ -31,30 +31,67 @@ void Image::Load() {
         cout << Name_ << ": texture null" << endl;
         throw std::exception{};
     }
+    Width_ = Surface_->w;
+    Height_ = Surface_->h;
 }
 
-// images are identical, if their names are identical
+void Image::Unload() {
+    SDL_FreeSurface(Surface_);
+    Surface_ = nullptr;
+}
+
+// images are identical, if their names are identical, names are interned into symbol IDs when images are found
 bool Image::operator==(const Image &image) const {
-    return Name_ == image.Name_;
+    return Id_ == image.Id_;
 }
 
-void ImageLoader::Load() {
+void ImageLoader::Load(SDL_Renderer* renderer) {
     findImageFiles();
-    for (auto&& image : Images_) {
+    for (const auto& assetPath : assetPaths_) {
+        Assets_.emplace_back(assetPath, fs::path(assetPath).stem().string(), static_cast<SymbolId>(Assets_.size()));
+    }
+    pack(renderer);
+}
+
+void ImageLoader::Reload(SDL_Renderer* renderer) {
+    // surfaces were freed after the atlas was built, so they are loaded from files again
+    pack(renderer);
+}
+
+void ImageLoader::pack(SDL_Renderer* renderer) {
+    vector<Image*> packed{};
+    for (auto* images : {&Images_, &Assets_}) {
+        for (auto&& image : *images) {
+            packed.push_back(&image);
+        }
+    }
+    for (Image* image : packed) {
         try {
-            image.Load();
+            image->Load();
         } catch (...) {
-            cout << "cannot load image " << image.Name_ << endl;
+            cout << "cannot load image " << image->Name_ << endl;
             throw;
         }
     }
-
+    Atlas_.Build(renderer, packed);
+    // only the atlas is drawn, so full size images are not needed anymore
+    for (Image* image : packed) {
+        image->Unload();
+    }
 }
 
 void ImageLoader::findImageFiles() {
+    if (imageCount_ > MAX_SYMBOL_COUNT) {
+        throw invalid_argument("Too many images requested");
+    }
+    // names of files in a directory are unique, so every image gets its own symbol ID
     for (const auto & entry : fs::directory_iterator(DirectoryPath_)) {
+        if (Images_.size() == MAX_SYMBOL_COUNT) {
+            break;
+        }
         if (entry.path().extension().string() == ".png") {
-            Images_.emplace_back(entry.path().string(), entry.path().stem().string());
+            auto id = static_cast<SymbolId>(Images_.size());
+            Images_.emplace_back(entry.path().string(), entry.path().stem().string(), id);
         }
     }
     if (Images_.size() < imageCount_) {
@@ -7,7 +7,11 @@
 
 #include "SDL.h"
 #include "SDL_image.h"
+#include "symbol.h"
+#include "texture_atlas.h"
 
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <utility>
 #include <vector>
@@ -17,7 +21,8 @@
  */
 class Image {
 public:
-    Image(std::string filePath, std::string name) : FilePath_(std::move(filePath)), Name_(std::move(name)) {}
+    Image(std::string filePath, std::string name, SymbolId id)
+        : FilePath_(std::move(filePath)), Name_(std::move(name)), Id_(id) {}
     /**
      * Path to image file
      */
@@ -27,17 +32,41 @@ public:
      */
     std::string Name_;
     /**
-     * Surface loaded from file
+     * Symbol ID, unique for every image name
      */
-    SDL_Surface* Surface_;
+    SymbolId Id_;
+    /**
+     * Surface loaded from file, it is freed when the image is packed into the atlas (see ImageLoader::Load)
+     */
+    SDL_Surface* Surface_ = nullptr;
+    /**
+     * Width of the image in file, kept after the surface is freed
+     */
+    int Width_ = 0;
+    /**
+     * Height of the image in file, kept after the surface is freed
+     */
+    int Height_ = 0;
+    /**
+     * Atlas texture containing the image, renderer rotates and scales it when drawing
+     */
+    SDL_Texture* Texture_ = nullptr;
+    /**
+     * Place of the image in the atlas texture, it can be smaller than the image in file
+     */
+    SDL_Rect TextureRect_{0, 0, 0, 0};
     /**
      * Loads image from file as surface
      */
     void Load();
     /**
-     * Compare images based on their names
+     * Free surface loaded from file
+     */
+    void Unload();
+    /**
+     * Compare images based on their symbol IDs
      * @param image Image to compare to
-     * @return
+     * @return true if both images show the same symbol
      */
     bool operator==(const Image& image) const;
 };
@@ -47,8 +76,17 @@ public:
  */
 class ImageLoader {
 public:
-    explicit ImageLoader(std::string directoryPath, int imageCount)
-        : DirectoryPath_(std::move(directoryPath)), imageCount_(imageCount) {}
+    /**
+     * Maximal number of images, that can be given a symbol ID
+     */
+    static const int MAX_SYMBOL_COUNT = std::numeric_limits<SymbolId>::max() + 1;
+    /**
+     * @param directoryPath Path to directory with images of symbols
+     * @param imageCount Number of images of symbols
+     * @param assetPaths Paths to images shown outside of cards (e.g. heart), in order of Assets_
+     */
+    explicit ImageLoader(std::string directoryPath, int imageCount, std::vector<std::string> assetPaths = {})
+        : DirectoryPath_(std::move(directoryPath)), imageCount_(imageCount), assetPaths_(std::move(assetPaths)) {}
     /**
      * Path to directory from which images are loaded
      */
@@ -58,9 +96,27 @@ public:
      */
     std::vector<Image> Images_{};
     /**
-     * Find images in the directory and load them
+     * List of loaded images shown outside of cards
      */
-    void Load();
+    std::vector<Image> Assets_{};
+    /**
+     * Atlas containing all images and assets
+     */
+    TextureAtlas Atlas_{};
+    /**
+     * Find images in the directory, assign their symbol IDs and load them, load assets
+     *
+     * All images and assets are packed into atlas textures and uploaded to the renderer once,
+     * the atlas must outlive all copies of the images. Surfaces loaded from files are freed after that.
+     * @param renderer Renderer used to create textures
+     */
+    void Load(SDL_Renderer* renderer);
+    /**
+     * Load images and assets from files again and rebuild the atlas, e.g. after the renderer lost all textures.
+     * Images keep their addresses, only their textures and places in textures change.
+     * @param renderer Renderer used to create textures
+     */
+    void Reload(SDL_Renderer* renderer);
     /**
      * Load image from the given file as texture
      * @param filePath Path to image file
@@ -76,7 +132,9 @@ public:
     static SDL_Surface* LoadSurface(const std::string& filePath);
 private:
     void findImageFiles();
+    void pack(SDL_Renderer* renderer);
     int imageCount_;
+    std::vector<std::string> assetPaths_;
 
 };
 
@@ -0,0 +1,135 @@
+#include "incidence.h"
+
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+IncidenceTable::IncidenceTable(int lineCount, int pointCount, int incidenceCount)
+    : lineCount_(lineCount), pointCount_(pointCount), incidenceCount_(incidenceCount) {
+    data_.assign(GetDataSize(lineCount, pointCount, incidenceCount), 0);
+}
+
+IncidenceTable::IncidenceTable(const int* data, int lineCount, int pointCount, int incidenceCount)
+    : view_(data), lineCount_(lineCount), pointCount_(pointCount), incidenceCount_(incidenceCount),
+      linesAdded_(lineCount) {}
+
+int IncidenceTable::GetIncidenceCount(int lineCount, int lineSize) {
+    long long count = (long long)lineCount * lineSize;
+    if (lineCount < 0 || lineSize < 0 || count > INT_MAX) {
+        throw length_error("Incidence table of " + to_string(lineCount) + " lines with " + to_string(lineSize)
+                           + " points is too large, at most " + to_string(INT_MAX) + " points are supported");
+    }
+    return static_cast<int>(count);
+}
+
+int* IncidenceTable::AddLine(int size) {
+    if (linesAdded_ == lineCount_) {
+        throw logic_error("All lines were already added");
+    }
+    int* offsets = lineOffsets();
+    int start = offsets[linesAdded_];
+    if (start + size > incidenceCount_) {
+        throw logic_error("Incidence table is full");
+    }
+    linesAdded_++;
+    offsets[linesAdded_] = start + size;
+    return linePoints() + start;
+}
+
+int* IncidenceTable::AddLines(int count, int size) {
+    if (linesAdded_ + count > lineCount_) {
+        throw logic_error("Too many lines added");
+    }
+    int* offsets = lineOffsets();
+    int start = offsets[linesAdded_];
+    if ((long long)start + (long long)count * size > incidenceCount_) {
+        throw logic_error("Incidence table is full");
+    }
+    for (int line = 1; line <= count; ++line) {
+        offsets[linesAdded_ + line] = start + line * size;
+    }
+    linesAdded_ += count;
+    return linePoints() + start;
+}
+
+void IncidenceTable::BuildPointIndex() {
+    // counting sort of (line, point) pairs by point
+    int* offsets = pointOffsets();
+    const int* points = linePoints();
+    int used = lineOffsets()[linesAdded_];
+    fill(offsets, offsets + pointCount_ + 1, 0);
+    for (int i = 0; i < used; ++i) {
+        offsets[points[i] + 1]++;
+    }
+    for (int point = 0; point < pointCount_; ++point) {
+        offsets[point + 1] += offsets[point];
+    }
+    int* lines = pointLines();
+    const int* starts = lineOffsets();
+    for (int line = 0; line < linesAdded_; ++line) {
+        for (int i = starts[line]; i < starts[line + 1]; ++i) {
+            lines[offsets[points[i]]++] = line;
+        }
+    }
+    // offsets were moved to the end of each range while filling, shift them back
+    for (int point = pointCount_; point > 0; --point) {
+        offsets[point] = offsets[point - 1];
+    }
+    offsets[0] = 0;
+}
+
+void IncidenceTable::BuildPointIndexByDuality() {
+    if (lineCount_ != pointCount_) {
+        throw logic_error("Table with different number of lines and points is not self-dual");
+    }
+    copy(lineOffsets(), lineOffsets() + lineCount_ + 1, pointOffsets());
+    copy(linePoints(), linePoints() + incidenceCount_, pointLines());
+}
+
+IndexSpan IncidenceTable::GetLine(int line) const {
+    const int* offsets = lineOffsets();
+    return {linePoints() + offsets[line], linePoints() + offsets[line + 1]};
+}
+
+IndexSpan IncidenceTable::GetLinesThrough(int point) const {
+    const int* offsets = pointOffsets();
+    return {pointLines() + offsets[point], pointLines() + offsets[point + 1]};
+}
+
+int* IncidenceTable::lineOffsets() {
+    if (view_ != nullptr) {
+        throw logic_error("Incidence table is read only");
+    }
+    return data_.data();
+}
+
+int* IncidenceTable::linePoints() {
+    return lineOffsets() + lineCount_ + 1;
+}
+
+int* IncidenceTable::pointOffsets() {
+    return linePoints() + incidenceCount_;
+}
+
+int* IncidenceTable::pointLines() {
+    return pointOffsets() + pointCount_ + 1;
+}
+
+const int* IncidenceTable::lineOffsets() const {
+    return view_ != nullptr ? view_ : data_.data();
+}
+
+const int* IncidenceTable::linePoints() const {
+    return lineOffsets() + lineCount_ + 1;
+}
+
+const int* IncidenceTable::pointOffsets() const {
+    return linePoints() + incidenceCount_;
+}
+
+const int* IncidenceTable::pointLines() const {
+    return pointOffsets() + pointCount_ + 1;
+}
@@ -0,0 +1,157 @@
+#ifndef COBBLE_SRC_INCIDENCE_H
+#define COBBLE_SRC_INCIDENCE_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Read only range of indexes inside of an incidence table
+ */
+class IndexSpan {
+public:
+    IndexSpan(const int* begin, const int* end) : begin_(begin), end_(end) {}
+    const int* begin() const {
+        return begin_;
+    }
+    const int* end() const {
+        return end_;
+    }
+    int size() const {
+        return static_cast<int>(end_ - begin_);
+    }
+    int operator[](int idx) const {
+        return begin_[idx];
+    }
+private:
+    const int* begin_;
+    const int* end_;
+};
+
+/**
+ * Incidence structure between lines and points (cards and symbols) in compressed sparse row form
+ *
+ * Everything is stored in a single allocation, split into 4 arrays:
+ * - line offsets (lineCount + 1) - points of line i are stored between offsets i and i + 1
+ * - points of all lines (incidenceCount)
+ * - point offsets (pointCount + 1) - lines through point i are stored between offsets i and i + 1
+ * - lines through all points (incidenceCount)
+ *
+ * Table is filled line by line with AddLine, reverse index (point -> lines) is then built with BuildPointIndex.
+ * Table can also be a read only view of data stored elsewhere in the same layout (e.g. tables built at compile time).
+ */
+class IncidenceTable {
+public:
+    IncidenceTable() = default;
+    /**
+     * Allocate empty table
+     * @param lineCount Number of lines
+     * @param pointCount Number of points
+     * @param incidenceCount Total number of points on all lines
+     */
+    IncidenceTable(int lineCount, int pointCount, int incidenceCount);
+    /**
+     * Create read only view of complete table data, data must outlive the table
+     * @param data Table data, including the point index
+     * @param lineCount Number of lines
+     * @param pointCount Number of points
+     * @param incidenceCount Total number of points on all lines
+     */
+    IncidenceTable(const int* data, int lineCount, int pointCount, int incidenceCount);
+    /**
+     * Add next line to the table
+     * @param size Number of points on the line
+     * @return Place for the points of the line, caller fills in their indexes
+     */
+    int* AddLine(int size);
+    /**
+     * Add next lines, which all have the same number of points
+     * @param count Number of lines
+     * @param size Number of points on each line
+     * @return Place for the points of all lines, one line after another
+     */
+    int* AddLines(int count, int size);
+    /**
+     * Build the point -> lines index, call after all lines are added
+     */
+    void BuildPointIndex();
+    /**
+     * Build the point -> lines index of a self-dual table by copying the lines,
+     * valid only if point i lies on line j exactly when point j lies on line i.
+     * Call after all lines are added.
+     */
+    void BuildPointIndexByDuality();
+    /**
+     * Get points on line
+     * @param line Index of line
+     * @return Indexes of points
+     */
+    IndexSpan GetLine(int line) const;
+    /**
+     * Get lines going through a point
+     * @param point Index of point
+     * @return Indexes of lines
+     */
+    IndexSpan GetLinesThrough(int point) const;
+    int GetLineCount() const {
+        return lineCount_;
+    }
+    int GetPointCount() const {
+        return pointCount_;
+    }
+    int GetIncidenceCount() const {
+        return incidenceCount_;
+    }
+    /**
+     * Get raw table data (all 4 arrays one after another), e.g. to save the table to file
+     * @return Table data
+     */
+    const int* GetData() const {
+        return lineOffsets();
+    }
+    /**
+     * Get size of raw table data
+     * @return Number of integers in table data
+     */
+    size_t GetDataSize() const {
+        return GetDataSize(lineCount_, pointCount_, incidenceCount_);
+    }
+    /**
+     * Get size of raw data of a table
+     * @param lineCount Number of lines
+     * @param pointCount Number of points
+     * @param incidenceCount Total number of points on all lines
+     * @return Number of integers in table data
+     */
+    static size_t GetDataSize(int lineCount, int pointCount, int incidenceCount) {
+        return (size_t)lineCount + 1 + pointCount + 1 + 2 * (size_t)incidenceCount;
+    }
+    /**
+     * Get total number of points on lines of the same size.
+     *
+     * Offsets in the table are 32 bit integers, so the total is limited to INT_MAX
+     * (e.g. projective planes up to order 1289), larger planes can be generated only in chunks.
+     * @param lineCount Number of lines
+     * @param lineSize Number of points on each line
+     * @return Number of incidences
+     * @throws std::length_error if the table would be too large
+     */
+    static int GetIncidenceCount(int lineCount, int lineSize);
+
+private:
+    std::vector<int> data_{};
+    const int* view_ = nullptr;
+    int lineCount_ = 0;
+    int pointCount_ = 0;
+    int incidenceCount_ = 0;
+    int linesAdded_ = 0;
+    int* lineOffsets();
+    int* linePoints();
+    int* pointOffsets();
+    int* pointLines();
+    const int* lineOffsets() const;
+    const int* linePoints() const;
+    const int* pointOffsets() const;
+    const int* pointLines() const;
+};
+
+#endif //COBBLE_SRC_INCIDENCE_H
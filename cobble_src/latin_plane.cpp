@@ -0,0 +1,44 @@
+#include "latin_plane.h"
+#include "parallel.h"
+
+using namespace std;
+
+LatinSquarePlane::LatinSquarePlane(int order)
+        : n_(order), pointCount_(order * order + order + 1), field_(order) {}
+
+void LatinSquarePlane::GetLine(int line, int* points) const {
+    if (line == 0) {
+        for (int point = 0; point <= n_; ++point) {
+            *points++ = point;
+        }
+        return;
+    }
+    int lineClass = (line - 1) / n_;
+    int s = (line - 1) % n_;
+    *points++ = lineClass;
+    int affineBegin = n_ + 1;
+    if (lineClass == n_) {
+        // row s
+        for (int c = 0; c < n_; ++c) {
+            *points++ = affineBegin + s * n_ + c;
+        }
+        return;
+    }
+    // j*r + c = s, so c = s - j*r
+    for (int r = 0; r < n_; ++r) {
+        int c = field_.Sub(s, field_.Mul(lineClass, r));
+        *points++ = affineBegin + r * n_ + c;
+    }
+}
+
+IncidenceTable LatinSquarePlane::Generate(int threadCount) const {
+    IncidenceTable table{pointCount_, pointCount_, IncidenceTable::GetIncidenceCount(pointCount_, n_ + 1)};
+    int* points = table.AddLines(pointCount_, n_ + 1);
+    Parallel::For(0, pointCount_, threadCount, [&](int lineBegin, int lineEnd) {
+        for (int line = lineBegin; line < lineEnd; ++line) {
+            GetLine(line, points + (size_t)line * (n_ + 1));
+        }
+    });
+    table.BuildPointIndex();
+    return table;
+}
@@ -0,0 +1,52 @@
+#ifndef COBBLE_SRC_LATIN_PLANE_H
+#define COBBLE_SRC_LATIN_PLANE_H
+
+#include "finite_field.h"
+#include "incidence.h"
+
+/**
+ * Projective plane built as an affine plane completed by a line at infinity (Latin square construction)
+ *
+ * Generating:
+ * - n is the order of the plane, n must be a prime power
+ * - affine plane has n^2 points (r, c), r and c from GF(n), and n + 1 classes of n parallel lines
+ * - class j < n is given by the Latin square L_j(r, c) = j*r + c, line s of the class is {(r, c) : L_j(r, c) = s},
+ *   squares L_1 .. L_(n-1) are mutually orthogonal, L_0 gives the columns
+ * - class n are the rows {(s, c)}
+ * - every class gets its own point at infinity, which is added to all lines of the class,
+ *   lines at infinity of all classes form the line at infinity
+ *
+ * Points and lines are numbered by indexes in this order:
+ * - points at infinity 0 .. n (one per class), then affine points (r, c) as n + 1 + r*n + c
+ * - line at infinity, then lines of classes 0 .. n, line s of class j has index 1 + j*n + s
+ * Points of every line are in ascending order.
+ */
+class LatinSquarePlane {
+public:
+    /**
+     * @param order Order of the plane (must be a prime power)
+     */
+    explicit LatinSquarePlane(int order);
+    /**
+     * Compute points of a line in O(n).
+     * @param line Index of line
+     * @param points Place for (n + 1) indexes of points on the line
+     */
+    void GetLine(int line, int* points) const;
+    /**
+     * Generate all lines of the plane, lines are split into ranges generated in parallel.
+     * @param threadCount Number of threads used to generate lines
+     * @return Incidence table of lines and points of the plane
+     */
+    IncidenceTable Generate(int threadCount = 1) const;
+    int GetPointCount() const {
+        return pointCount_;
+    }
+
+private:
+    int n_;
+    int pointCount_;
+    GaloisField field_;
+};
+
+#endif //COBBLE_SRC_LATIN_PLANE_H
@@ -3,6 +3,7 @@
 #include "SDL2_gfxPrimitives.h"
 #include "cobble.h"
 #include "projective_plane.h"
+#include "random.h"
 
 #include <stdio.h>
 #include <string>
@@ -15,19 +16,9 @@
 #define SCREEN_WIDTH    1000
 #define SCREEN_HEIGHT   600
 #define WINDOW_TITLE    "Cobble"
+#define HEART_IMAGE     "./data/assets/heart.png"
 
 
-bool isPrime(int number) {
-    int divider = 2;
-    while (divider < number) {
-        if (number % divider == 0) {
-            return false;
-        }
-        divider++;
-    }
-    return true;
-}
-
 /**
  * Class responsible for parsing user configuration
  *
@@ -38,20 +29,36 @@ class ArgParser {
 public:
     std::string ImageDir_;
     int ImagesPerCard_;
+    /**
+     * Seed of random numbers, taken from the system if not set, it is not cached
+     */
+    uint64_t Seed_ = 0;
+    /**
+     * Number of cards in the deck, 0 for the full deck, it is not cached
+     */
+    int CardCount_ = 0;
+    /**
+     * Endless mode, it is not cached
+     */
+    bool Endless_ = false;
+    /**
+     * Low power mode - the game waits for input and redraws only when something changed, it is not cached
+     */
+    bool LowPower_ = false;
     /**
      * Parse configuration
      * @param arg command line arguments
      */
     void Parse(std::vector<std::string>& arg) {
-        if (arg.size() > 1) {
-            if (arg.size() == 3) {
-                parseOption(arg[1], arg[2]);
-            } else if (arg.size() == 5) {
-                parseOption(arg[1], arg[2]);
-                parseOption(arg[3], arg[4]);
-            } else {
-                throw std::invalid_argument("Too many arguments");
-            }
+        // every option has a value
+        if (arg.size() % 2 == 0) {
+            throw std::invalid_argument("Every option must have a value");
+        }
+        for (size_t i = 1; i + 1 < arg.size(); i += 2) {
+            parseOption(arg[i], arg[i + 1]);
+        }
+        if (!seedSet_) {
+            Seed_ = Random::GenerateSeed();
         }
         std::string imageConfig = "configure_image_dir.txt";
         if (imageDirSet_) {
@@ -68,8 +75,16 @@ public:
             ImagesPerCard_ = std::stoi(value);
         }
 
-        if (!isPrime(ImagesPerCard_ - 1)) {
-            throw std::invalid_argument("Number of images on card - 1 must be a prime number.");
+        if (ImagesPerCard_ < 2) {
+            throw std::invalid_argument("Number of images on card must be at least 2.");
+        }
+        if (ProjectivePlane::GetSizeFromOrder(ImagesPerCard_ - 1) > ImageLoader::MAX_SYMBOL_COUNT) {
+            throw std::invalid_argument("Number of images on card is too large, deck can have at most "
+                                        + std::to_string(ImageLoader::MAX_SYMBOL_COUNT) + " images.");
+        }
+        int fullCardCount = ProjectivePlane::GetSizeFromOrder(ImagesPerCard_ - 1);
+        if (CardCount_ != 0 && (CardCount_ < 2 || CardCount_ > fullCardCount)) {
+            throw std::invalid_argument("Number of cards in deck must be between 2 and " + std::to_string(fullCardCount) + ".");
         }
     }
     /**
@@ -79,10 +94,15 @@ public:
         std::cout << "Usage:" << std::endl;
         std::cout << "-i <path> : sets path to the directory with images used in game" << std::endl;
         std::cout << "-c <number> : sets number of images per card" << std::endl;
+        std::cout << "-n <number> : sets number of cards in deck, 0 for all cards" << std::endl;
+        std::cout << "--seed <number> : sets seed of random numbers to replay a session" << std::endl;
+        std::cout << "--endless <0|1> : reshuffles the deck instead of ending the game, pairs of cards repeat only after all pairs were shown" << std::endl;
+        std::cout << "--low-power <0|1> : redraws the screen only after input or when the remaining time changes" << std::endl;
     }
 private:
     bool imageDirSet_ = false;
     bool imageCountSet_ = false;
+    bool seedSet_ = false;
     std::string configDir_ = "./data/configure/";
     void parseOption(std::string& option, std::string& value) {
         if (option == "-i") {
@@ -95,6 +115,29 @@ private:
             } catch (const std::exception& error) {
                 throw std::invalid_argument("Number of images on card (-c) must be integer but was: " + value);
             }
+        } else if (option == "-n") {
+            try {
+                CardCount_ = std::stoi(value);
+            } catch (const std::exception& error) {
+                throw std::invalid_argument("Number of cards in deck (-n) must be integer but was: " + value);
+            }
+        } else if (option == "--endless") {
+            if (value != "0" && value != "1") {
+                throw std::invalid_argument("Endless mode (--endless) must be 0 or 1 but was: " + value);
+            }
+            Endless_ = value == "1";
+        } else if (option == "--low-power") {
+            if (value != "0" && value != "1") {
+                throw std::invalid_argument("Low power mode (--low-power) must be 0 or 1 but was: " + value);
+            }
+            LowPower_ = value == "1";
+        } else if (option == "--seed") {
+            try {
+                Seed_ = std::stoull(value);
+                seedSet_ = true;
+            } catch (const std::exception& error) {
+                throw std::invalid_argument("Seed (--seed) must be a non-negative integer but was: " + value);
+            }
         } else {
             throw std::invalid_argument("Unknown option " + option);
         }
@@ -119,6 +162,73 @@ private:
     }
 };
 
+/**
+ * Handle one event
+ * @param game Game
+ * @param loader Loader of images of the game
+ * @param event Event
+ * @return Whether the game should quit
+ */
+bool handleEvent(Game& game, ImageLoader& loader, const SDL_Event& event) {
+    switch (event.type) {
+        case SDL_QUIT:
+            return true;
+//        case SDL_KEYDOWN:           return true;
+        case SDL_MOUSEBUTTONDOWN:
+            int mouseX, mouseY;
+            SDL_GetMouseState(&mouseX, &mouseY);
+            game.Screen_->UpdateOnClick(mouseX, mouseY);
+            return false;
+        case SDL_WINDOWEVENT_CLOSE:
+            return true;
+        case SDL_RENDER_TARGETS_RESET:
+            // contents of render targets were lost (e.g. Direct3D after resize), cards are rendered again
+            game.CardTextures_.Clear();
+            return false;
+        case SDL_RENDER_DEVICE_RESET:
+            // all textures were lost, the atlas is rebuilt and cards are rendered again
+            loader.Reload(game.Renderer_);
+            game.ResetTextures(loader.Images_);
+            return false;
+        default:
+//            SDL_Log("Window %d got unknown event %d\n", event.window.windowID, event.window.event);
+            return false;
+    }
+}
+
+/**
+ * Main loop, that sleeps until an event arrives or until the displayed remaining time changes
+ *
+ * The screen is redrawn only after a click, a window event (e.g. the window was uncovered), a loss of textures
+ * or when the time of the next update of the game (see Game::GetTimeToNextUpdate) is reached.
+ * @param game Game
+ * @param loader Loader of images of the game
+ */
+void runLowPower(Game& game, ImageLoader& loader) {
+    SDL_Event event;
+    bool quit = false;
+    bool redraw = true;
+    Uint64 nextUpdate = 0; // ticks, when the screen changes without input, 0 for never
+    while (!quit) {
+        game.Update();
+        Uint64 now = SDL_GetTicks64();
+        if (redraw || (nextUpdate != 0 && now >= nextUpdate)) {
+            game.Draw();
+            long timeToUpdate = game.GetTimeToNextUpdate();
+            nextUpdate = timeToUpdate < 0 ? 0 : now + timeToUpdate;
+        }
+        int timeout = nextUpdate == 0 ? -1 : static_cast<int>(nextUpdate > now ? nextUpdate - now : 0);
+        redraw = false;
+        if (SDL_WaitEventTimeout(&event, timeout)) {
+            // the wait can be long, time must be current before a click is scored
+            game.Update();
+            quit = handleEvent(game, loader, event);
+            redraw = event.type == SDL_MOUSEBUTTONDOWN || event.type == SDL_WINDOWEVENT
+                     || event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET;
+        }
+    }
+}
+
 //---------------------------------------------------------------------
 //  MAIN
 //---------------------------------------------------------------------
@@ -166,9 +276,9 @@ int main(int argc, char** argv) {
 
     int imagesCount = ProjectivePlane::GetSizeFromOrder(parser.ImagesPerCard_ - 1);
 
-    ImageLoader loader{parser.ImageDir_, imagesCount};
+    ImageLoader loader{parser.ImageDir_, imagesCount, {HEART_IMAGE}};
     try {
-        loader.Load();
+        loader.Load(renderer);
     } catch(const std::invalid_argument& error) {
         std::cout << "Not enough images loaded." << std::endl;
         std::cout << imagesCount << " images needed but only " << loader.Images_.size() << " loaded from directory " << parser.ImageDir_ << std::endl;
@@ -176,7 +286,10 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    Game game {SCREEN_WIDTH, SCREEN_HEIGHT, renderer, parser.ImagesPerCard_, loader.Images_};
+    std::cout << "seed: " << parser.Seed_ << std::endl; // run with --seed to replay the session
+    Game game {SCREEN_WIDTH, SCREEN_HEIGHT, renderer, parser.ImagesPerCard_, loader.Images_, parser.CardCount_, parser.Seed_,
+              parser.Endless_};
+    game.HeartImage_ = &loader.Assets_[0];
     game.Init();
 
 
@@ -193,34 +306,26 @@ int main(int argc, char** argv) {
     // Wait for Events to quit & close the window
     //-----------------------------------------------------
     SDL_Delay(1000);  // Wait 1 sec for greasy fingers
-    bool eQuit = false;
-    while (!eQuit) {
-
-        game.Update();
-        game.Draw();
-        while(SDL_PollEvent(&wEvent)) {
-            switch (wEvent.type) {
-                case SDL_QUIT:
-                    eQuit = true;
-                    break;
-//                case SDL_KEYDOWN:           eQuit = true; break;
-                case SDL_MOUSEBUTTONDOWN:
-                    int mouseX, mouseY;
-                    SDL_GetMouseState(&mouseX, &mouseY);
-                    game.Screen_->UpdateOnClick(mouseX, mouseY);
+    if (parser.LowPower_) {
+        runLowPower(game, loader);
+    } else {
+        bool eQuit = false;
+        while (!eQuit) {
+            game.Update();
+            game.Draw();
+            while (SDL_PollEvent(&wEvent)) {
+                eQuit = handleEvent(game, loader, wEvent) || eQuit;
+                if (wEvent.type == SDL_MOUSEBUTTONDOWN) {
                     game.Screen_->Draw();
-                    break;
-                case SDL_WINDOWEVENT_CLOSE:
-                    eQuit = true;
-                    break;
-                default:
-//                    SDL_Log("Window %d got unknown event %d\n", wEvent.window.windowID, wEvent.window.event);
-                    break;
+                }
             }
+            SDL_Delay(100); // Keep < 500 [ms]
         }
-        SDL_Delay(100); // Keep < 500 [ms]
     }
 
+    // textures must be destroyed before their renderer
+    game.CardTextures_.Clear();
+    loader.Atlas_.Clear();
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
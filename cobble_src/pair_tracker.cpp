@@ -0,0 +1,88 @@
+#include "pair_tracker.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+PairTracker::PairTracker(int itemCount)
+        : itemCount_(itemCount), visited_((pairIndex(0, itemCount) + 63) / 64), unvisitedCounts_(itemCount) {
+    if (itemCount < 2) {
+        throw invalid_argument("Pairs need at least 2 items");
+    }
+    Reset();
+}
+
+bool PairTracker::IsVisited(int item1, int item2) const {
+    size_t bit = pairIndex(item1, item2);
+    return (visited_[bit / 64] >> (bit % 64)) & 1;
+}
+
+void PairTracker::Visit(int item1, int item2) {
+    if (item1 == item2 || IsVisited(item1, item2)) {
+        return;
+    }
+    size_t bit = pairIndex(item1, item2);
+    visited_[bit / 64] |= uint64_t{1} << (bit % 64);
+    unvisitedCounts_[item1]--;
+    unvisitedCounts_[item2]--;
+    unvisitedPairCount_--;
+}
+
+int PairTracker::FindUnvisitedPartner(int item, int start) const {
+    if (unvisitedCounts_[item] == 0) {
+        return -1;
+    }
+    int partner = findPartner(item, start, itemCount_);
+    return partner != -1 ? partner : findPartner(item, 0, start);
+}
+
+int PairTracker::FindItemWithUnvisitedPartner(int start) const {
+    for (int idx = 0; idx < itemCount_; ++idx) {
+        int item = (start + idx) % itemCount_;
+        if (unvisitedCounts_[item] > 0) {
+            return item;
+        }
+    }
+    return -1;
+}
+
+void PairTracker::Reset() {
+    fill(visited_.begin(), visited_.end(), 0);
+    fill(unvisitedCounts_.begin(), unvisitedCounts_.end(), itemCount_ - 1);
+    unvisitedPairCount_ = static_cast<long long>(pairIndex(0, itemCount_));
+}
+
+size_t PairTracker::pairIndex(int item1, int item2) {
+    if (item1 > item2) {
+        swap(item1, item2);
+    }
+    return static_cast<size_t>(item2) * (item2 - 1) / 2 + item1;
+}
+
+int PairTracker::findPartner(int item, int begin, int end) const {
+    // smaller partners - contiguous bits, whole words of visited pairs are skipped
+    size_t base = pairIndex(0, item);
+    size_t bit = base + begin;
+    size_t last = base + min(end, item);
+    while (bit < last) {
+        uint64_t unvisited = ~visited_[bit / 64] >> (bit % 64);
+        if (unvisited == 0) {
+            bit = (bit / 64 + 1) * 64;
+            continue;
+        }
+        for (; (unvisited & 1) == 0; unvisited >>= 1) {
+            bit++;
+        }
+        if (bit < last) {
+            return static_cast<int>(bit - base);
+        }
+    }
+    // larger partners - one bit in every row
+    for (int partner = max(begin, item + 1); partner < end; ++partner) {
+        if (!IsVisited(item, partner)) {
+            return partner;
+        }
+    }
+    return -1;
+}
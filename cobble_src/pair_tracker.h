@@ -0,0 +1,75 @@
+#ifndef COBBLE_SRC_PAIR_TRACKER_H
+#define COBBLE_SRC_PAIR_TRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Set of visited pairs of items (e.g. pairs of cards already shown together)
+ *
+ * Every unordered pair {i, j}, i < j, has 1 bit in a triangular bitmap at index j * (j - 1) / 2 + i,
+ * so N items need N * (N - 1) / 2 bits (about 62 KB for the 993 cards of order 31).
+ * Partners smaller than an item lie in one contiguous run of bits, which is searched word by word,
+ * larger partners are probed bit by bit. Number of unvisited partners of every item is kept,
+ * so items without unvisited partners are skipped without touching the bitmap.
+ */
+class PairTracker {
+public:
+    /**
+     * @param itemCount Number of items
+     */
+    explicit PairTracker(int itemCount);
+    int GetItemCount() const {
+        return itemCount_;
+    }
+    /**
+     * Get number of pairs, which were not visited yet
+     * @return Number of pairs
+     */
+    long long GetUnvisitedPairCount() const {
+        return unvisitedPairCount_;
+    }
+    /**
+     * Get number of partners, which were not visited with an item yet
+     * @param item Item
+     * @return Number of partners
+     */
+    int GetUnvisitedPartnerCount(int item) const {
+        return unvisitedCounts_[item];
+    }
+    bool IsVisited(int item1, int item2) const;
+    /**
+     * Mark pair of different items as visited
+     * @param item1 First item
+     * @param item2 Second item
+     */
+    void Visit(int item1, int item2);
+    /**
+     * Find partner, which was not visited with an item yet
+     * @param item Item
+     * @param start Item where the search starts, it continues cyclically (random start gives random partner)
+     * @return Partner, -1 if the item was visited with all other items
+     */
+    int FindUnvisitedPartner(int item, int start) const;
+    /**
+     * Find item, which has at least 1 unvisited partner
+     * @param start Item where the search starts, it continues cyclically
+     * @return Item, -1 if all pairs were visited
+     */
+    int FindItemWithUnvisitedPartner(int start) const;
+    /**
+     * Mark all pairs as unvisited
+     */
+    void Reset();
+
+private:
+    int itemCount_;
+    long long unvisitedPairCount_ = 0;
+    std::vector<uint64_t> visited_;
+    std::vector<int> unvisitedCounts_;
+    static size_t pairIndex(int item1, int item2);
+    int findPartner(int item, int begin, int end) const;
+};
+
+#endif //COBBLE_SRC_PAIR_TRACKER_H
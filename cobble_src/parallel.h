@@ -0,0 +1,80 @@
+#ifndef COBBLE_SRC_PARALLEL_H
+#define COBBLE_SRC_PARALLEL_H
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+/**
+ * Utilities for splitting work between threads
+ */
+class Parallel {
+public:
+    /**
+     * Get number of threads the hardware can run at once
+     * @return Number of threads, at least 1
+     */
+    static int GetThreadCount() {
+        int count = static_cast<int>(std::thread::hardware_concurrency());
+        return count > 0 ? count : 1;
+    }
+    /**
+     * Split range of indexes into contiguous parts of the same size and process each part in its own thread.
+     *
+     * The calling thread processes the first part, function returns after all parts are done.
+     * If any part throws, all threads are still joined and then the exception of the first such part is rethrown.
+     * @param begin First index of the range
+     * @param end Index after the last index of the range
+     * @param threadCount Maximal number of threads
+     * @param function Function called as function(partBegin, partEnd) for every part
+     */
+    template<typename Function>
+    static void For(int begin, int end, int threadCount, const Function& function) {
+        long long count = end - begin;
+        if (count <= 0) {
+            return;
+        }
+        threadCount = static_cast<int>(std::min<long long>(std::max(threadCount, 1), count));
+        std::vector<std::exception_ptr> errors(threadCount);
+        std::vector<std::thread> threads{};
+        // threads must be joined even when a part (or creating a thread) throws, destroying a joinable thread terminates
+        struct JoinGuard {
+            std::vector<std::thread>& Threads_;
+            ~JoinGuard() {
+                for (auto&& thread : Threads_) {
+                    if (thread.joinable()) {
+                        thread.join();
+                    }
+                }
+            }
+        } guard{threads};
+        threads.reserve(threadCount - 1);
+        for (int part = 1; part < threadCount; ++part) {
+            int partBegin = begin + static_cast<int>(count * part / threadCount);
+            int partEnd = begin + static_cast<int>(count * (part + 1) / threadCount);
+            threads.emplace_back([&function, &errors, part, partBegin, partEnd]() {
+                try {
+                    function(partBegin, partEnd);
+                } catch (...) {
+                    errors[part] = std::current_exception();
+                }
+            });
+        }
+        try {
+            function(begin, begin + static_cast<int>(count / threadCount));
+        } catch (...) {
+            errors[0] = std::current_exception();
+        }
+        for (auto&& thread : threads) {
+            thread.join();
+        }
+        for (auto&& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+};
+
+#endif //COBBLE_SRC_PARALLEL_H
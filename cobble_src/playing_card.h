@@ -0,0 +1,52 @@
+#ifndef COBBLE_SRC_PLAYING_CARD_H
+#define COBBLE_SRC_PLAYING_CARD_H
+
+#include "projective_plane.h"
+#include "symbol.h"
+
+/**
+ * Playing card containing symbols
+ *
+ * Card refers to IDs of its symbols stored by its deck in one table for all cards,
+ * images are shared by all cards in the list of all images.
+ */
+class Card {
+public:
+    Card() = default;
+    /**
+     * @param id Index of the line in the projective plane, that the card represents
+     * @param equation Equation of the line
+     * @param symbols IDs of symbols on the card, owned by the deck, they must outlive the card
+     * @param symbolCount Number of symbols on the card
+     */
+    Card(int id, Point equation, const SymbolId* symbols, int symbolCount)
+            : Id_(id), Equation_(equation), symbols_(symbols), symbolCount_(symbolCount) {}
+    /**
+     * Index of the line in the projective plane, that the card represents
+     */
+    int Id_ = 0;
+    /**
+     * Equation of the line, that the card represents
+     */
+    Point Equation_{0, 0, 0};
+    /**
+     * Get number of symbols on the card
+     * @return Number of symbols, 0 for a card, which was not created by a deck
+     */
+    int GetSymbolCount() const {
+        return symbolCount_;
+    }
+    /**
+     * Get symbol on the card
+     * @param idx Position of the symbol on the card
+     * @return ID of the symbol, which is also the index of its image in the list of all images
+     */
+    SymbolId GetSymbol(int idx) const {
+        return symbols_[idx];
+    }
+private:
+    const SymbolId* symbols_ = nullptr;
+    int symbolCount_ = 0;
+};
+
+#endif //COBBLE_SRC_PLAYING_CARD_H
@@ -3,6 +3,14 @@
 //
 
 #include "projective_plane.h"
+#include "static_plane.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
 
 using namespace std;
 
@@ -10,36 +18,86 @@ std::ostream& operator << (std::ostream &os, const Point &p) {
     return (os << p.x << " " << p.y << " " << p.z  << std::endl);
 }
 
-std::vector<LinePoints> ProjectivePlane::Generate() {
-    // generate points of PP
-    vector<Point> points = generatePoints();
-    vector<Point> lineEquations = generatePoints();
-    std::vector<LinePoints> result {};
-    for(auto&& lineEq : lineEquations) {
-        auto line = findPointsOnLine(lineEq, points);
-        result.push_back(line);
+IncidenceTable ProjectivePlane::Generate(int threadCount) const {
+    IncidenceTable table{};
+    if (StaticPlanes::Find(n_, table)) {
+        return table;
+    }
+    table = IncidenceTable{pointCount_, pointCount_, IncidenceTable::GetIncidenceCount(pointCount_, n_ + 1)};
+    int* points = table.AddLines(pointCount_, n_ + 1);
+    Parallel::For(0, pointCount_, threadCount, [&](int lineBegin, int lineEnd) {
+        generateLines(lineBegin, lineEnd, points + (size_t)lineBegin * (n_ + 1));
+    });
+    // point i lies on line j exactly when point j lies on line i
+    table.BuildPointIndexByDuality();
+    return table;
+}
+
+void ProjectivePlane::GenerateChunks(int chunkLines, int threadCount, const ChunkConsumer& consumer) const {
+    if (chunkLines <= 0) {
+        throw invalid_argument("Number of lines in a chunk must be positive but was " + to_string(chunkLines));
+    }
+    threadCount = max(threadCount, 1);
+    chunkLines = min(chunkLines, pointCount_);
+    vector<vector<int>> buffers(threadCount, vector<int>((size_t)chunkLines * (n_ + 1)));
+    for (int batchBegin = 0; batchBegin < pointCount_; batchBegin += chunkLines * threadCount) {
+        int chunkCount = min(threadCount, (pointCount_ - batchBegin + chunkLines - 1) / chunkLines);
+        auto chunkBegin = [&](int chunk) { return batchBegin + chunk * chunkLines; };
+        auto chunkEnd = [&](int chunk) { return min(chunkBegin(chunk) + chunkLines, pointCount_); };
+        Parallel::For(0, chunkCount, chunkCount, [&](int firstChunk, int lastChunk) {
+            for (int chunk = firstChunk; chunk < lastChunk; ++chunk) {
+                generateLines(chunkBegin(chunk), chunkEnd(chunk), buffers[chunk].data());
+            }
+        });
+        for (int chunk = 0; chunk < chunkCount; ++chunk) {
+            consumer(chunkBegin(chunk), chunkEnd(chunk) - chunkBegin(chunk), buffers[chunk].data());
+        }
+    }
+}
+
+void ProjectivePlane::GenerateToFile(const std::string& filePath, int chunkLines, int threadCount) const {
+    ofstream file{filePath, ios::binary};
+    if (!file.good()) {
+        throw invalid_argument("Cannot open file " + filePath);
     }
-    return result;
+    int32_t order = n_;
+    file.write(reinterpret_cast<const char*>(&order), sizeof(order));
+    vector<int32_t> converted{};
+    GenerateChunks(chunkLines, threadCount, [&](int /*firstLine*/, int lineCount, const int* points) {
+        converted.assign(points, points + (size_t)lineCount * (n_ + 1));
+        file.write(reinterpret_cast<const char*>(converted.data()), converted.size() * sizeof(int32_t));
+    });
 }
 
-vector<LineIdx> ProjectivePlane::ConvertPointsToIdx(const vector<LinePoints> & plane) {
-    vector<LineIdx> result {};
-    for (auto&& line : plane) {
-        vector<int> lineConverted {};
+void ProjectivePlane::generateLines(int lineBegin, int lineEnd, int* points) const {
+    auto lineSolver = solver();
+    for (int lineIdx = lineBegin; lineIdx < lineEnd; ++lineIdx, points += n_ + 1) {
+        lineSolver.SolveLine(lineSolver.ConvertFromIdx(lineIdx), points);
+    }
+}
+
+IncidenceTable ProjectivePlane::GenerateByScan() const {
+    // generate points of PP
+    vector<Point> points = generatePoints();
+    IncidenceTable table{pointCount_, pointCount_, IncidenceTable::GetIncidenceCount(pointCount_, n_ + 1)};
+    auto lineSolver = solver();
+    for (int lineIdx = 0; lineIdx < pointCount_; ++lineIdx) {
+        auto line = findPointsOnLine(lineSolver.ConvertFromIdx(lineIdx), points);
+        int* linePoints = table.AddLine(line.size());
         for (auto&& point : line) {
-            auto pointConverted = convertToIdx(point);
-            lineConverted.push_back(pointConverted);
+            *linePoints++ = lineSolver.ConvertToIdx(point);
         }
-        result.push_back(lineConverted);
     }
-    return result;
+    table.BuildPointIndex();
+    return table;
 }
 
 vector<Point> ProjectivePlane::findPointsOnLine(const Point& lineEquation, const vector<Point>& points) const {
     vector<Point> line {};
     for(auto&& point : points) {
         // substitute point coordinates into line equation
-        int equationResult = (lineEquation.x * point.x + lineEquation.y * point.y + lineEquation.z * point.z) % n_;
+        int equationResult = field_.Add(field_.Add(field_.Mul(lineEquation.x, point.x), field_.Mul(lineEquation.y, point.y)),
+                                        field_.Mul(lineEquation.z, point.z));
         if (equationResult == 0) {
             line.push_back(point);
         }
@@ -47,7 +105,6 @@ vector<Point> ProjectivePlane::findPointsOnLine(const Point& lineEquation, const
     return line;
 }
 
-
 std::vector<Point> ProjectivePlane::generatePoints() const {
     vector<Point> points {};
     points.emplace_back(1, 0, 0); // 1 point
@@ -59,13 +116,3 @@ std::vector<Point> ProjectivePlane::generatePoints() const {
     }
     return points;
 }
-
-int ProjectivePlane::convertToIdx(Point point) const {
-    if (point.y == 0 && point.z == 0) {
-        return 0;
-    }
-    if (point.z == 0) {
-        return point.x + point.y;
-    }
-    return point.x * n_ + point.y + n_ + 1;
-}
\ No newline at end of file
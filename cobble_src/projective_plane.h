@@ -5,8 +5,13 @@
 #ifndef COBBLE_SRC_PROJECTIVE_PLANE_H
 #define COBBLE_SRC_PROJECTIVE_PLANE_H
 
+#include "finite_field.h"
+#include "incidence.h"
+
+#include <functional>
 #include <vector>
 #include <iostream>
+#include <string>
 
 /**
  * Point inside of projective plane
@@ -16,19 +21,125 @@ public:
     int x; /** x coordinate */
     int y; /** y coordinate */
     int z; /** z coordinate */
-    Point(int x, int y, int z) : x(x), y(y), z(z) {}
+    constexpr Point(int x, int y, int z) : x(x), y(y), z(z) {}
 };
 
+std::ostream& operator << (std::ostream &os, const Point &p);
+
 /**
- * Line in a projective plane represented by indexes of its points
- */
-using LineIdx = std::vector<int>;
-/**
- * Line in a projective plane represented by its points
+ * Closed form construction of lines of a projective plane with coordinates from a finite field
+ *
+ * Shared by planes generated at runtime (ProjectivePlane) and at compile time (StaticProjectivePlane).
+ * @tparam Field Finite field of coordinates
  */
-using LinePoints = std::vector<Point>;
-
-std::ostream& operator << (std::ostream &os, const Point &p);
+template<typename Field>
+class PlaneSolver {
+public:
+    /**
+     * @param field Field of order n
+     * @param order Order of the plane (n)
+     */
+    constexpr PlaneSolver(const Field& field, int order) : field_(field), n_(order) {}
+    /**
+     * Convert point (or line equation) to its index.
+     * @param point Representative of the point
+     * @return Index of point
+     */
+    constexpr int ConvertToIdx(const Point& point) const {
+        if (point.y == 0 && point.z == 0) {
+            return 0;
+        }
+        if (point.z == 0) {
+            return point.x + point.y;
+        }
+        return point.x * n_ + point.y + n_ + 1;
+    }
+    /**
+     * Convert index to point (or line equation).
+     * @param idx Index of point
+     * @return Representative of the point
+     */
+    constexpr Point ConvertFromIdx(int idx) const {
+        if (idx == 0) {
+            return {1, 0, 0};
+        }
+        if (idx <= n_) {
+            return {idx - 1, 1, 0};
+        }
+        idx -= n_ + 1;
+        return {idx / n_, idx % n_, 1};
+    }
+    /**
+     * Normalize point to the representative with 1 on the last non-zero coordinate.
+     * @param point Any non-zero triple
+     * @return Representative of the point
+     */
+    constexpr Point Normalize(const Point& point) const {
+        if (point.z != 0) {
+            int zInv = field_.Inv(point.z);
+            return {field_.Mul(point.x, zInv), field_.Mul(point.y, zInv), 1};
+        }
+        if (point.y != 0) {
+            return {field_.Div(point.x, point.y), 1, 0};
+        }
+        return {1, 0, 0};
+    }
+    /**
+     * Find the common point of 2 different lines as the cross product of their equations.
+     * @param line1 Equation of first line
+     * @param line2 Equation of second line
+     * @return Index of the intersection
+     */
+    constexpr int Intersect(const Point& line1, const Point& line2) const {
+        Point cross {
+            field_.Sub(field_.Mul(line1.y, line2.z), field_.Mul(line1.z, line2.y)),
+            field_.Sub(field_.Mul(line1.z, line2.x), field_.Mul(line1.x, line2.z)),
+            field_.Sub(field_.Mul(line1.x, line2.y), field_.Mul(line1.y, line2.x))
+        };
+        return ConvertToIdx(Normalize(cross));
+    }
+    /**
+     * Find all points on a line.
+     * @param lineEquation Line a*x + b*y + c*z = 0 given as (a, b, c)
+     * @param points Place for (n + 1) indexes of points on the line
+     */
+    constexpr void SolveLine(const Point& lineEquation, int* points) const {
+        int a = lineEquation.x;
+        int b = lineEquation.y;
+        int c = lineEquation.z;
+        // points at infinity (z = 0)
+        if (a == 0) {
+            *points++ = ConvertToIdx({1, 0, 0});
+            if (b == 0) {
+                // line at infinity contains all of them
+                for (int x = 0; x < n_; ++x) {
+                    *points++ = ConvertToIdx({x, 1, 0});
+                }
+            }
+        } else {
+            // a*x + b = 0
+            *points++ = ConvertToIdx({field_.Neg(field_.Div(b, a)), 1, 0});
+        }
+        // points (x, y, 1)
+        if (b != 0) {
+            // y = -(a*x + c) / b
+            int bInv = field_.Inv(b);
+            for (int x = 0; x < n_; ++x) {
+                int y = field_.Neg(field_.Mul(field_.Add(field_.Mul(a, x), c), bInv));
+                *points++ = ConvertToIdx({x, y, 1});
+            }
+        } else if (a != 0) {
+            // x = -c / a
+            int x = field_.Neg(field_.Div(c, a));
+            for (int y = 0; y < n_; ++y) {
+                *points++ = ConvertToIdx({x, y, 1});
+            }
+        }
+    }
+private:
+    const Field& field_;
+    int n_;
+};
 
 /**
  * Finite projective plane
@@ -38,43 +149,169 @@ std::ostream& operator << (std::ostream &os, const Point &p);
  * - any 2 lines intersect at exactly 1 point
  *
  * Generating:
- * - n is the order of the plane, n must be prime
- * - we take triples of numbers from Z_n - (x, y, z), excluding (0, 0, 0)
- * - we define equivalency where (x, y, z) ~ (l*x, l*y, l*z) for some l from Z_p
+ * - n is the order of the plane, n must be a prime power
+ * - we take triples of elements of the finite field GF(n) - (x, y, z), excluding (0, 0, 0)
+ * - we define equivalency where (x, y, z) ~ (l*x, l*y, l*z) for some non-zero l from GF(n)
  * - we define points on the plane as representatives of equivalency classes that have a 1 on the last non-zero coordinate
  * - that gives as (n^2 + n + 1) points: (x, y, 1) - n^2, (x, 1, 0) - n, (1, 0, 0) - 1
  * - we represent lines with equation a*x + b*y + c = 0, where (a, b, c) are also representatives of equivalency classes
  * - that gives as (n^2 + n + 1) lines
  * - we define lines as collections of points that fit the line equation
+ * - points of a line are found directly from its equation: for each x we solve the equation for y,
+ *   which gives n points (or n points with fixed x, if b = 0), then we add the point at infinity (z = 0)
+ *
+ * Points and lines are numbered by indexes in this order:
+ * - first (1, 0, 0)
+ * - then all points (x, 1, 0) in lexicographic order
+ * - then all points (x, y, 1) in lexicographic order
+ * Line with index i has the equation given by the point with index i.
  */
 class ProjectivePlane {
 public:
     /**
-     * @param order order of the plane (n is prime)
+     * Function receiving generated lines: consumer(firstLine, lineCount, points),
+     * points contain (n + 1) indexes for each line in order
      */
-    explicit ProjectivePlane(int order) : n_(order) {
+    using ChunkConsumer = std::function<void(int firstLine, int lineCount, const int* points)>;
+    /**
+     * @param order order of the plane (n is a prime power)
+     */
+    explicit ProjectivePlane(int order) : n_(order), field_(order) {
         pointCount_ = GetSizeFromOrder(order);
     }
     /**
      * Generate the plane of order n.
-     * @return List of lines of the plane represented by points which the lines contain
+     *
+     * Every line is built directly from its equation, total work is O(N * (n + 1)) for N lines.
+     * Planes of small orders are taken from tables built at compile time (see StaticPlanes).
+     * Lines are independent, so they are split into ranges generated in parallel.
+     * @param threadCount Number of threads used to generate lines
+     * @return Incidence table of lines and points of the plane
+     * @throws std::length_error if the plane is too large for an incidence table (order above 1289)
+     */
+    IncidenceTable Generate(int threadCount = 1) const;
+    /**
+     * Generate the plane in chunks of lines without storing the whole plane.
+     *
+     * Chunks are generated in parallel, each thread generates one chunk at a time.
+     * Consumer is called from the calling thread with chunks in order of lines.
+     * @param chunkLines Number of lines in a chunk, must be positive
+     * @param threadCount Number of threads used to generate lines
+     * @param consumer Function receiving generated chunks
+     * @throws std::invalid_argument if the number of lines in a chunk is not positive
      */
-    std::vector<LinePoints> Generate();
+    void GenerateChunks(int chunkLines, int threadCount, const ChunkConsumer& consumer) const;
     /**
-     * Convert points in plane from coordinates to indexes.
+     * Generate the plane in chunks and write it to a binary file.
      *
-     * Indexes are taken from this ordering of the points:
-     * - first (1, 0, 0)
-     * - then all points (x, 1, 0) in lexicographic order
-     * - then all points (x, y, 0) in lexicographic order
+     * File contains the order n followed by (n + 1) point indexes of every line, all as 32 bit integers.
+     * @param filePath Path to output file
+     * @param chunkLines Number of lines in a chunk
+     * @param threadCount Number of threads used to generate lines
+     */
+    void GenerateToFile(const std::string& filePath, int chunkLines, int threadCount) const;
+    /**
+     * Generate the plane of order n by testing every point against every line equation.
      *
-     * @param plane Plane with lines represented by points
-     * @return Plane with lines represented by indexes of points
+     * Reference construction with O(N^2) work, used to benchmark and verify Generate.
+     * @return Incidence table of lines and points of the plane
+     */
+    IncidenceTable GenerateByScan() const;
+    /**
+     * Compute points of one line on demand in O(n).
+     * @param line Index of line
+     * @param points Place for (n + 1) indexes of points on the line
+     */
+    void GetLine(int line, int* points) const {
+        auto lineSolver = solver();
+        lineSolver.SolveLine(lineSolver.ConvertFromIdx(line), points);
+    }
+    /**
+     * Compute points of one line on demand in O(n).
+     * @param line Index of line
+     * @return Indexes of points on the line
+     */
+    std::vector<int> GetLine(int line) const {
+        std::vector<int> points(n_ + 1);
+        GetLine(line, points.data());
+        return points;
+    }
+
+    /**
+     * Iterator over lines of the plane, each line is computed when the iterator reaches it
+     */
+    class LineIterator {
+    public:
+        LineIterator(const ProjectivePlane* plane, int line) : plane_(plane), line_(line) {
+            load();
+        }
+        /**
+         * @return Indexes of points on the current line
+         */
+        const std::vector<int>& operator*() const {
+            return points_;
+        }
+        LineIterator& operator++() {
+            line_++;
+            load();
+            return *this;
+        }
+        bool operator!=(const LineIterator& other) const {
+            return line_ != other.line_;
+        }
+        /**
+         * @return Index of the current line
+         */
+        int GetLineIdx() const {
+            return line_;
+        }
+    private:
+        const ProjectivePlane* plane_;
+        int line_;
+        std::vector<int> points_{};
+        void load() {
+            if (line_ < plane_->pointCount_) {
+                points_.resize(plane_->n_ + 1);
+                plane_->GetLine(line_, points_.data());
+            }
+        }
+    };
+    /**
+     * Iterate over lines without generating the whole plane
+     */
+    LineIterator begin() const {
+        return {this, 0};
+    }
+    LineIterator end() const {
+        return {this, pointCount_};
+    }
+    /**
+     * Get equation of a line.
+     * @param line Index of line
+     * @return Line a*x + b*y + c*z = 0 given as (a, b, c)
      */
-    std::vector<LineIdx> ConvertPointsToIdx(const std::vector<LinePoints> & plane);
+    Point GetLineEquation(int line) const {
+        return solver().ConvertFromIdx(line);
+    }
+    /**
+     * Get the common point of 2 different lines in O(1).
+     * @param line1 Equation of first line
+     * @param line2 Equation of second line
+     * @return Index of the common point
+     */
+    int GetCommonPoint(const Point& line1, const Point& line2) const {
+        return solver().Intersect(line1, line2);
+    }
     int GetPointCount() const {
         return pointCount_;
     }
+    /**
+     * Get number of points on every line
+     * @return Order of the plane + 1
+     */
+    int GetLineSize() const {
+        return n_ + 1;
+    }
 
     static int GetSizeFromOrder(int order) {
         return order * order + order + 1;
@@ -83,9 +320,13 @@ public:
 private:
     int pointCount_;
     int n_;
+    GaloisField field_;
     std::vector<Point> generatePoints() const;
-    int convertToIdx(Point point) const;
     std::vector<Point> findPointsOnLine(const Point& lineEquation, const std::vector<Point>& points) const;
+    PlaneSolver<GaloisField> solver() const {
+        return {field_, n_};
+    }
+    void generateLines(int lineBegin, int lineEnd, int* points) const;
 
 };
 
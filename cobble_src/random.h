@@ -0,0 +1,118 @@
+#ifndef COBBLE_SRC_RANDOM_H
+#define COBBLE_SRC_RANDOM_H
+
+#include <cstdint>
+#include <random>
+
+/**
+ * Independent streams of random numbers used by parts of the game
+ *
+ * Every part gets its own generator, so e.g. the number of drawn cards does not change the order of the deck.
+ */
+enum class RandomStream : uint64_t {
+    Deck = 1,
+    Layout = 2,
+    Simulation = 3,
+};
+
+/**
+ * Fast generator of pseudo-random numbers (xoshiro256**)
+ *
+ * Generator has no global state, every thread or part of the game owns its generator.
+ * Same seed and stream always give the same sequence of numbers, so sessions can be reproduced.
+ */
+class Random {
+public:
+    /**
+     * Create generator
+     * @param seed Seed of the sequence
+     * @param stream Number of the stream, generators with the same seed and different streams are independent
+     */
+    explicit Random(uint64_t seed, uint64_t stream = 0) {
+        // state is filled by SplitMix64, which turns similar seeds into unrelated states
+        uint64_t splitMix = seed ^ mix(stream + GOLDEN_GAMMA);
+        for (auto&& word : state_) {
+            splitMix += GOLDEN_GAMMA;
+            word = mix(splitMix);
+        }
+    }
+    /**
+     * Create a seed from the system source of randomness
+     * @return New seed
+     */
+    static uint64_t GenerateSeed() {
+        std::random_device device{};
+        return (static_cast<uint64_t>(device()) << 32) ^ device();
+    }
+    /**
+     * Get next random number
+     * @return Uniformly distributed 64 bit number
+     */
+    uint64_t Next() {
+        uint64_t result = rotateLeft(state_[1] * 5, 7) * 9;
+        uint64_t shifted = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= shifted;
+        state_[3] = rotateLeft(state_[3], 45);
+        return result;
+    }
+    /**
+     * Get random number from range [0, bound) without modulo bias (Lemire's method)
+     * @param bound Number of possible values, must be positive
+     * @return Uniformly distributed number
+     */
+    int NextInt(int bound) {
+        auto range = static_cast<uint32_t>(bound);
+        uint64_t product = (Next() >> 32) * range;
+        auto low = static_cast<uint32_t>(product);
+        if (low < range) {
+            uint32_t threshold = (0u - range) % range;
+            while (low < threshold) {
+                product = (Next() >> 32) * range;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return static_cast<int>(product >> 32);
+    }
+    /**
+     * Advance the generator by 2^128 numbers.
+     *
+     * Copies of one generator jumped different number of times give non-overlapping sequences for parallel work.
+     */
+    void Jump() {
+        static constexpr uint64_t JUMP[] = {0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull,
+                                            0xa9582618e03fc9aaull, 0x39abdc4529b1661cull};
+        uint64_t jumped[4] = {0, 0, 0, 0};
+        for (uint64_t jump : JUMP) {
+            for (int bit = 0; bit < 64; ++bit) {
+                if (jump & (uint64_t{1} << bit)) {
+                    for (int i = 0; i < 4; ++i) {
+                        jumped[i] ^= state_[i];
+                    }
+                }
+                Next();
+            }
+        }
+        for (int i = 0; i < 4; ++i) {
+            state_[i] = jumped[i];
+        }
+    }
+
+private:
+    static constexpr uint64_t GOLDEN_GAMMA = 0x9e3779b97f4a7c15ull;
+    uint64_t state_[4];
+    static uint64_t rotateLeft(uint64_t value, int shift) {
+        return (value << shift) | (value >> (64 - shift));
+    }
+    // finalizer of SplitMix64
+    static uint64_t mix(uint64_t value) {
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+        return value ^ (value >> 31);
+    }
+};
+
+#endif //COBBLE_SRC_RANDOM_H
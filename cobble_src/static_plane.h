@@ -0,0 +1,94 @@
+#ifndef COBBLE_SRC_STATIC_PLANE_H
+#define COBBLE_SRC_STATIC_PLANE_H
+
+#include "finite_field.h"
+#include "incidence.h"
+#include "projective_plane.h"
+
+#include <array>
+
+/**
+ * Projective plane of order N generated at compile time
+ *
+ * Lines are built the same way as in ProjectivePlane::Generate, the result is stored
+ * in a constant array with the layout of IncidenceTable, so using the plane costs nothing at runtime.
+ * @tparam N Order of the plane (must be a prime power)
+ */
+template<int N>
+class StaticProjectivePlane {
+public:
+    static constexpr int POINT_COUNT = N * N + N + 1;
+    static constexpr int LINE_SIZE = N + 1;
+    static constexpr int INCIDENCE_COUNT = POINT_COUNT * LINE_SIZE;
+    static constexpr int DATA_SIZE = 2 * (POINT_COUNT + 1) + 2 * INCIDENCE_COUNT;
+    using Data = std::array<int, DATA_SIZE>;
+
+    /**
+     * Get the plane as incidence table
+     * @return Read only view of the table built at compile time
+     */
+    static IncidenceTable GetTable() {
+        return IncidenceTable{DATA.data(), POINT_COUNT, POINT_COUNT, INCIDENCE_COUNT};
+    }
+
+private:
+    static constexpr Data build() {
+        Data data{};
+        StaticGaloisField<N> field{N};
+        PlaneSolver<StaticGaloisField<N>> solver{field, N};
+        // line offsets and lines
+        int* lineOffsets = data.data();
+        int* linePoints = lineOffsets + POINT_COUNT + 1;
+        for (int line = 0; line < POINT_COUNT; ++line) {
+            lineOffsets[line] = line * LINE_SIZE;
+            solver.SolveLine(solver.ConvertFromIdx(line), linePoints + line * LINE_SIZE);
+        }
+        lineOffsets[POINT_COUNT] = INCIDENCE_COUNT;
+        // plane is self-dual, point index is a copy of the lines
+        int* pointOffsets = linePoints + INCIDENCE_COUNT;
+        for (int i = 0; i < POINT_COUNT + 1 + INCIDENCE_COUNT; ++i) {
+            pointOffsets[i] = lineOffsets[i];
+        }
+        return data;
+    }
+
+    static constexpr Data DATA = build();
+};
+
+/**
+ * Planes generated at compile time
+ *
+ * Contains orders of the decks shipped with the game (3 and 4 symbols per card) and all orders up to 7.
+ */
+class StaticPlanes {
+public:
+    /**
+     * Get plane of the given order, if it was generated at compile time.
+     * @param order Order of the plane
+     * @param table Set to the plane if found
+     * @return true if the plane was found
+     */
+    static bool Find(int order, IncidenceTable& table) {
+        switch (order) {
+            case 2:
+                table = StaticProjectivePlane<2>::GetTable();
+                return true;
+            case 3:
+                table = StaticProjectivePlane<3>::GetTable();
+                return true;
+            case 4:
+                table = StaticProjectivePlane<4>::GetTable();
+                return true;
+            case 5:
+                table = StaticProjectivePlane<5>::GetTable();
+                return true;
+            case 7:
+                table = StaticProjectivePlane<7>::GetTable();
+                return true;
+            default:
+                return false;
+        }
+    }
+};
+
+#endif //COBBLE_SRC_STATIC_PLANE_H
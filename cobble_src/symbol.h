@@ -0,0 +1,12 @@
+#ifndef COBBLE_SRC_SYMBOL_H
+#define COBBLE_SRC_SYMBOL_H
+
+#include <cstdint>
+
+/**
+ * Identifier of a symbol (image), symbols are numbered 0, 1, 2, ... in the order they are loaded.
+ * Symbol ID is also the index of the symbol in the list of all images and the index of a point of the projective plane.
+ */
+using SymbolId = uint16_t;
+
+#endif //COBBLE_SRC_SYMBOL_H
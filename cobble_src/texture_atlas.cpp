@@ -0,0 +1,94 @@
+#include "texture_atlas.h"
+#include "image_loader.h"
+
+#include "SDL2_rotozoom.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+using namespace std;
+
+void TextureAtlas::Build(SDL_Renderer* renderer, const vector<Image*>& images) {
+    SDL_RendererInfo info{};
+    int pageSize = MAX_PAGE_SIZE;
+    if (SDL_GetRendererInfo(renderer, &info) == 0 && info.max_texture_width > 0 && info.max_texture_height > 0) {
+        pageSize = min({pageSize, info.max_texture_width, info.max_texture_height});
+    }
+
+    // scale images down to fit a square grid on one page, zoom with smoothing also converts them to 32 bit RGBA
+    int gridSize = static_cast<int>(ceil(sqrt((double)images.size())));
+    int imageSize = max(MIN_IMAGE_SIZE, min(MAX_IMAGE_SIZE, pageSize / max(gridSize, 1) - 2 * PADDING));
+    vector<SDL_Surface*> scaled(images.size());
+    for (size_t i = 0; i < images.size(); ++i) {
+        SDL_Surface* surface = images[i]->Surface_;
+        double scale = min(1.0, imageSize / (double)max(surface->w, surface->h));
+        scaled[i] = zoomSurface(surface, scale, scale, SMOOTHING_ON);
+        if (scaled[i] == nullptr) {
+            throw runtime_error("Image " + images[i]->Name_ + " cannot be scaled");
+        }
+    }
+
+    // shelf packing, images sorted by height fill rows from left to right
+    vector<size_t> order(images.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    sort(order.begin(), order.end(), [&](size_t i1, size_t i2) { return scaled[i1]->h > scaled[i2]->h; });
+    vector<int> pageOf(images.size());
+    vector<SDL_Rect> pageSizes{};
+    int x = pageSize;
+    int y = 0;
+    int shelfHeight = 0;
+    for (size_t i : order) {
+        int width = scaled[i]->w + 2 * PADDING;
+        int height = scaled[i]->h + 2 * PADDING;
+        if (x + width > pageSize) {
+            // next shelf
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = height;
+            if (pageSizes.empty() || y + height > pageSize) {
+                pageSizes.push_back(SDL_Rect{0, 0, 0, 0});
+                y = 0;
+            }
+        }
+        SDL_Rect& page = pageSizes.back();
+        images[i]->TextureRect_ = SDL_Rect{x + PADDING, y + PADDING, scaled[i]->w, scaled[i]->h};
+        pageOf[i] = static_cast<int>(pageSizes.size()) - 1;
+        x += width;
+        page.w = max(page.w, x);
+        page.h = max(page.h, y + height);
+    }
+
+    // copy images into pages including their alpha channel, pages start fully transparent
+    pages_.clear();
+    for (size_t page = 0; page < pageSizes.size(); ++page) {
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, pageSizes[page].w, pageSizes[page].h, 32,
+                                                              SDL_PIXELFORMAT_RGBA32);
+        if (surface == nullptr) {
+            throw runtime_error(string("Atlas cannot be created: ") + SDL_GetError());
+        }
+        SDL_FillRect(surface, nullptr, 0);
+        for (size_t i = 0; i < images.size(); ++i) {
+            if (pageOf[i] == static_cast<int>(page)) {
+                SDL_Rect place = images[i]->TextureRect_;
+                SDL_SetSurfaceBlendMode(scaled[i], SDL_BLENDMODE_NONE);
+                SDL_BlitSurface(scaled[i], nullptr, surface, &place);
+            }
+        }
+        pages_.emplace_back(SDL_CreateTextureFromSurface(renderer, surface));
+        SDL_FreeSurface(surface);
+        if (pages_.back() == nullptr) {
+            throw runtime_error(string("Atlas texture cannot be created: ") + SDL_GetError());
+        }
+        SDL_SetTextureBlendMode(pages_.back().get(), SDL_BLENDMODE_BLEND);
+        // images are drawn smaller than they are and rotated, so they are filtered
+        SDL_SetTextureScaleMode(pages_.back().get(), SDL_ScaleModeLinear);
+    }
+    for (size_t i = 0; i < images.size(); ++i) {
+        images[i]->Texture_ = pages_[pageOf[i]].get();
+        SDL_FreeSurface(scaled[i]);
+    }
+}
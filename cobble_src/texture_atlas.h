@@ -0,0 +1,58 @@
+#ifndef COBBLE_SRC_TEXTURE_ATLAS_H
+#define COBBLE_SRC_TEXTURE_ATLAS_H
+
+#include "graphic_utils.h"
+
+#include "SDL.h"
+
+#include <vector>
+
+class Image;
+
+/**
+ * Few large textures (pages) holding many images, so that many images can be drawn with one draw call
+ *
+ * Images are scaled down, so that all of them fit into one page (but to at most MAX_IMAGE_SIZE and
+ * at least MIN_IMAGE_SIZE pixels), and packed into rows (shelves) sorted by height.
+ * Images are separated by transparent padding, so that linear filtering does not mix neighbouring images.
+ * Every image then refers to its page and to its place in the page (see Image::Texture_ and Image::TextureRect_).
+ */
+class TextureAtlas {
+public:
+    /**
+     * Larger side of packed images in pixels, larger images are scaled down
+     */
+    static const int MAX_IMAGE_SIZE = 256;
+    /**
+     * Smallest larger side of packed images in pixels, more pages are used if images do not fit into one
+     */
+    static const int MIN_IMAGE_SIZE = 16;
+    /**
+     * Transparent space around every image in pixels
+     */
+    static const int PADDING = 2;
+    /**
+     * Largest size of a page, smaller if the renderer does not support textures this large
+     */
+    static const int MAX_PAGE_SIZE = 4096;
+    /**
+     * Pack images into pages and upload them to the renderer
+     * @param renderer Renderer
+     * @param images Images with loaded surfaces, their textures and places in textures are set
+     */
+    void Build(SDL_Renderer* renderer, const std::vector<Image*>& images);
+    /**
+     * Destroy all pages, it must be called before the renderer is destroyed
+     */
+    void Clear() {
+        pages_.clear();
+    }
+    int GetPageCount() const {
+        return static_cast<int>(pages_.size());
+    }
+
+private:
+    std::vector<TexturePtr> pages_{};
+};
+
+#endif //COBBLE_SRC_TEXTURE_ATLAS_H